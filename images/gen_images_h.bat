@@ -1,13 +1,3 @@
-..\Obj\hexdump.exe arrow_01.png > ..\Obj\images.h
-..\Obj\hexdump.exe arrow_02.png >> ..\Obj\images.h
-..\Obj\hexdump.exe arrow_03.png >> ..\Obj\images.h
-..\Obj\hexdump.exe arrow_04.png >> ..\Obj\images.h
-..\Obj\hexdump.exe back1.png >> ..\Obj\images.h
-..\Obj\hexdump.exe back2.png >> ..\Obj\images.h
-..\Obj\hexdump.exe back3.png >> ..\Obj\images.h
-..\Obj\hexdump.exe button_01.png >> ..\Obj\images.h
-..\Obj\hexdump.exe button_02.png >> ..\Obj\images.h
-..\Obj\hexdump.exe button_03.png >> ..\Obj\images.h
-..\Obj\hexdump.exe button_04.png >> ..\Obj\images.h
-..\Obj\hexdump.exe button_05.png >> ..\Obj\images.h
-..\Obj\hexdump.exe pad_controls_v02.png >> ..\Obj\images.h
+if not exist ..\Obj\assets mkdir ..\Obj\assets
+for %%i in (arrow_01 arrow_02 arrow_03 arrow_04 back1 back2 back3 button_01 button_02 button_03 button_04 button_05 pad_controls_v02) do ..\Obj\assetc.exe image %%i.png ..\Obj\assets\%%i.bin || exit /b 1
+..\Obj\assetc.exe lang ..\src\lang.txt ..\Obj\lang.h
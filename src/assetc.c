@@ -0,0 +1,963 @@
+/**
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ */
+
+/**
+ * Asset compiler, replaces hexdump.c, format_lang.c and xxd.
+ *
+ * usage: assetc image input.png output.bin
+ *          Decodes a PNG image and writes it as a single-entry pack that can
+ *          be loaded without libpng/zlib (see assetpack.h).  The output is
+ *          embedded as an RCDATA resource (see SonicLauncher.rc).
+ *
+ *        assetc lang lang.txt lang.h
+ *          Creates the string ID enum and the interned string table of the
+ *          built-in languages from the translation table.
+ *
+ *        assetc langpack table.txt column output.lang
+ *          Writes one column of a translation table with the same rows as
+ *          lang.txt as a language pack that the launcher loads at runtime.
+ *
+ *        assetc -bench input.png [input.png ...]
+ *          Compares decoding with libpng against the asset pack.
+ *
+ * Outputs are only written if their content changed, so timestamp based
+ * build systems don't recompile anything that depends on them.  Images also
+ * keep a content hash of their input in "output.bin.hash" and are not
+ * re-encoded at all if it matches.
+ */
+
+#include <png.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "assetpack.h"
+#include "cpu.h"
+
+/* store the indices uncompressed if LZ4 doesn't save at least 1/8 */
+#define RAW_THRESHOLD(n)  ((n) - (n) / 8)
+
+#define HASH_BITS  16
+#define MINMATCH   4
+#define MFLIMIT       12  /* the last match starts at least 12 bytes before the end */
+#define LASTLITERALS  5  /* and ends at least 5 bytes before it */
+#define MAXOFFSET  65535
+#define CHAIN_DEPTH  256
+
+#define BENCH_SECONDS  0.25
+
+/* change this if the output of the image encoder changes */
+#define ENCODER_VERSION  "assetc image 1"
+
+
+typedef struct {
+  char name[ASSETPACK_NAME_SIZE + 1];
+  unsigned w, h, d;
+  unsigned palcount;
+  unsigned char pal[256 * 4];
+  unsigned char *data;  /* indices or pixels */
+  size_t dataLen;
+  unsigned char *payload;
+  size_t payloadLen;
+  unsigned codec;
+  long pngSize;
+} image_t;
+
+
+static void wr16(unsigned char *p, unsigned v)
+{
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+}
+
+static void wr32(unsigned char *p, unsigned long v)
+{
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  p[2] = (v >> 16) & 0xFF;
+  p[3] = (v >> 24) & 0xFF;
+}
+
+static unsigned rd32(const unsigned char *p)
+{
+  return p[0] | p[1] << 8 | p[2] << 16 | (unsigned)p[3] << 24;
+}
+
+static void lz4_length(unsigned char **op, size_t len)
+{
+  while (len >= 255) {
+    *(*op)++ = 255;
+    len -= 255;
+  }
+  *(*op)++ = (unsigned char)len;
+}
+
+/* LZ4 block compression with hash chains and lazy matching; follows the
+ * end of block rules, so any LZ4 decoder accepts the output;
+ * dst must hold at least n + n/255 + 16 bytes */
+static size_t lz4_compress(const unsigned char *src, size_t n, unsigned char *dst)
+{
+  static long table[1 << HASH_BITS];
+  long *chain = malloc((n > 0 ? n : 1) * sizeof(long));
+  unsigned char *op = dst;
+  size_t ip = 0, anchor = 0, inserted = 0;
+  size_t matchLimit = (n > LASTLITERALS) ? n - LASTLITERALS : 0;
+
+  if (!chain) {
+    fprintf(stderr, "error: malloc()\n");
+    exit(1);
+  }
+
+  for (size_t i = 0; i < (1 << HASH_BITS); ++i) {
+    table[i] = -1;
+  }
+
+  while (ip + MFLIMIT <= n) {
+    size_t best = 0, bestRef = 0;
+
+    /* find the longest match at ip and at ip + 1 (lazy evaluation) */
+    for (size_t pos = ip; pos <= ip + 1 && pos + MFLIMIT <= n; ++pos) {
+      while (inserted <= pos && inserted + MINMATCH <= n) {
+        unsigned h = (rd32(src + inserted) * 2654435761U) >> (32 - HASH_BITS);
+        chain[inserted] = table[h];
+        table[h] = (long)inserted;
+        inserted++;
+      }
+
+      long ref = chain[pos];
+
+      for (int depth = 0; ref >= 0 && pos - ref <= MAXOFFSET && depth < CHAIN_DEPTH; ++depth) {
+        size_t len = 0;
+
+        while (pos + len < matchLimit && src[ref + len] == src[pos + len]) {
+          len++;
+        }
+
+        /* prefer the match at ip unless the next one is clearly longer */
+        if (len >= MINMATCH && len > best + (pos > ip ? 1 : 0)) {
+          best = len;
+          bestRef = (size_t)ref;
+          if (pos > ip) {
+            ip = pos;
+          }
+        }
+        ref = chain[ref];
+      }
+
+      if (best == 0) {
+        break;
+      }
+    }
+
+    if (best == 0) {
+      ip++;
+      continue;
+    }
+
+    size_t len = best;
+    size_t lit = ip - anchor;
+    unsigned char *token = op++;
+    *token = (unsigned char)(((lit < 15) ? lit : 15) << 4);
+    if (lit >= 15) {
+      lz4_length(&op, lit - 15);
+    }
+    memcpy(op, src + anchor, lit);
+    op += lit;
+
+    wr16(op, (unsigned)(ip - bestRef));
+    op += 2;
+
+    *token |= (len - MINMATCH < 15) ? (unsigned char)(len - MINMATCH) : 15;
+    if (len - MINMATCH >= 15) {
+      lz4_length(&op, len - MINMATCH - 15);
+    }
+
+    ip += len;
+    anchor = ip;
+  }
+
+  /* last literals */
+  size_t lit = n - anchor;
+  *op++ = (unsigned char)(((lit < 15) ? lit : 15) << 4);
+  if (lit >= 15) {
+    lz4_length(&op, lit - 15);
+  }
+  memcpy(op, src + anchor, lit);
+  op += lit;
+
+  free(chain);
+  return (size_t)(op - dst);
+}
+
+static void basename_noext(const char *path, char *out, size_t outLen)
+{
+  const char *p = path;
+  const char *s;
+  size_t len;
+
+  for (s = path; *s; ++s) {
+    if (*s == '/' || *s == '\\') {
+      p = s + 1;
+    }
+  }
+
+  s = strrchr(p, '.');
+  len = s ? (size_t)(s - p) : strlen(p);
+
+  if (len >= outLen) {
+    len = outLen - 1;
+  }
+  memcpy(out, p, len);
+  out[len] = 0;
+}
+
+static unsigned char *read_file(const char *path, size_t *len)
+{
+  FILE *fp = fopen(path, "rb");
+  unsigned char *buf;
+
+  if (!fp) {
+    return NULL;
+  }
+  fseek(fp, 0, SEEK_END);
+  *len = (size_t)ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  buf = malloc(*len);
+  if (fread(buf, 1, *len, fp) != *len) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(fp);
+  return buf;
+}
+
+/* FNV-1a */
+static unsigned long long hash_bytes(unsigned long long h, const unsigned char *p, size_t len)
+{
+  for (size_t i = 0; i < len; ++i) {
+    h ^= p[i];
+    h *= 0x100000001B3ULL;
+  }
+  return h;
+}
+
+/* write a file unless it already has exactly this content */
+static int write_if_changed(const char *path, const void *data, size_t len)
+{
+  size_t oldLen = 0;
+  unsigned char *old = read_file(path, &oldLen);
+  FILE *fp;
+
+  if (old) {
+    int same = (oldLen == len && memcmp(old, data, len) == 0);
+    free(old);
+    if (same) {
+      return 1;
+    }
+  }
+
+  if ((fp = fopen(path, "wb")) == NULL) {
+    fprintf(stderr, "error: cannot write file `%s'\n", path);
+    return 0;
+  }
+
+  if (fwrite(data, 1, len, fp) != len) {
+    fprintf(stderr, "error: fwrite()\n");
+    fclose(fp);
+    remove(path);
+    return 0;
+  }
+
+  fclose(fp);
+  return 1;
+}
+
+/* decode a PNG file into palette + indices (or RGB/RGBA pixels) */
+static int load_png(const char *path, image_t *img)
+{
+  FILE *fp;
+  png_structp png;
+  png_infop info;
+  png_colorp plte = NULL;
+  png_bytep trns = NULL;
+  png_bytep *rows;
+  int nplte = 0, ntrns = 0;
+  int color, depth;
+
+  memset(img, 0, sizeof(*img));
+  basename_noext(path, img->name, sizeof(img->name));
+
+  if ((fp = fopen(path, "rb")) == NULL) {
+    fprintf(stderr, "error: cannot read file `%s'\n", path);
+    return 0;
+  }
+
+  fseek(fp, 0, SEEK_END);
+  img->pngSize = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+  info = png_create_info_struct(png);
+
+  if (setjmp(png_jmpbuf(png))) {
+    fprintf(stderr, "error: cannot decode `%s'\n", path);
+    png_destroy_read_struct(&png, &info, NULL);
+    fclose(fp);
+    return 0;
+  }
+
+  png_init_io(png, fp);
+  png_read_info(png, info);
+
+  img->w = png_get_image_width(png, info);
+  img->h = png_get_image_height(png, info);
+  color = png_get_color_type(png, info);
+  depth = png_get_bit_depth(png, info);
+
+  if (img->w > 0xFFFF || img->h > 0xFFFF) {
+    fprintf(stderr, "error: `%s' is too large\n", path);
+    png_destroy_read_struct(&png, &info, NULL);
+    fclose(fp);
+    return 0;
+  }
+
+  if (color == PNG_COLOR_TYPE_PALETTE) {
+    png_get_PLTE(png, info, &plte, &nplte);
+    if (png_get_valid(png, info, PNG_INFO_tRNS)) {
+      png_get_tRNS(png, info, &trns, &ntrns, NULL);
+    }
+
+    img->palcount = (unsigned)nplte;
+    img->d = (ntrns > 0) ? 4 : 3;
+
+    for (int i = 0; i < nplte; ++i) {
+      unsigned char *p = img->pal + i * img->d;
+      p[0] = plte[i].red;
+      p[1] = plte[i].green;
+      p[2] = plte[i].blue;
+      if (img->d == 4) {
+        p[3] = (i < ntrns) ? trns[i] : 0xFF;
+      }
+    }
+
+    if (depth < 8) {
+      png_set_packing(png);
+    }
+  } else {
+    /* same conversions as Fl_PNG_Image */
+    if (color == PNG_COLOR_TYPE_GRAY || color == PNG_COLOR_TYPE_GRAY_ALPHA) {
+      png_set_gray_to_rgb(png);
+    }
+    if (png_get_valid(png, info, PNG_INFO_tRNS)) {
+      png_set_tRNS_to_alpha(png);
+    }
+    png_set_expand(png);
+    png_set_strip_16(png);
+
+    img->d = (color & PNG_COLOR_MASK_ALPHA || png_get_valid(png, info, PNG_INFO_tRNS)) ? 4 : 3;
+  }
+
+  png_read_update_info(png, info);
+
+  img->dataLen = (size_t)img->w * img->h * (img->palcount ? 1 : img->d);
+  img->data = malloc(img->dataLen);
+  rows = malloc(img->h * sizeof(png_bytep));
+
+  for (unsigned y = 0; y < img->h; ++y) {
+    rows[y] = img->data + (size_t)y * (img->dataLen / img->h);
+  }
+
+  png_read_image(png, rows);
+  png_read_end(png, NULL);
+  png_destroy_read_struct(&png, &info, NULL);
+  free(rows);
+  fclose(fp);
+
+  return 1;
+}
+
+static void pack_image(image_t *img)
+{
+  unsigned char *buf = malloc(img->dataLen + img->dataLen / 255 + 16);
+  size_t len = lz4_compress(img->data, img->dataLen, buf);
+
+  /* verify the round trip with the decoder used at runtime */
+  unsigned char *check = malloc(img->dataLen);
+  if (assetpack_lz4_decompress(buf, len, check, img->dataLen) != (int)img->dataLen ||
+      memcmp(check, img->data, img->dataLen) != 0)
+  {
+    fprintf(stderr, "error: LZ4 round trip failed for `%s'\n", img->name);
+    exit(1);
+  }
+  free(check);
+
+  if (len < RAW_THRESHOLD(img->dataLen)) {
+    img->codec = ASSETPACK_CODEC_LZ4;
+    img->payload = buf;
+    img->payloadLen = len;
+  } else {
+    img->codec = ASSETPACK_CODEC_RAW;
+    img->payload = img->data;
+    img->payloadLen = img->dataLen;
+    free(buf);
+  }
+}
+
+/* create a pack in memory; returns NULL on error */
+static unsigned char *pack_buffer(image_t *images, int count, size_t *len)
+{
+  unsigned char *buf, *p;
+  unsigned long offset = ASSETPACK_HEADER_SIZE + (unsigned long)count * ASSETPACK_ENTRY_SIZE;
+
+  *len = offset;
+  for (int i = 0; i < count; ++i) {
+    *len += images[i].palcount * images[i].d + images[i].payloadLen;
+  }
+
+  if ((buf = malloc(*len)) == NULL) {
+    return NULL;
+  }
+
+  memcpy(buf, ASSETPACK_MAGIC, 4);
+  wr16(buf + 4, ASSETPACK_VERSION);
+  wr16(buf + 6, (unsigned)count);
+  p = buf + ASSETPACK_HEADER_SIZE;
+
+  for (int i = 0; i < count; ++i, p += ASSETPACK_ENTRY_SIZE) {
+    image_t *img = &images[i];
+
+    memset(p, 0, ASSETPACK_ENTRY_SIZE);
+    strncpy((char *)p, img->name, ASSETPACK_NAME_SIZE);
+    wr32(p + 24, offset);
+    wr32(p + 28, (unsigned long)img->payloadLen);
+    wr16(p + 32, img->w);
+    wr16(p + 34, img->h);
+    p[36] = (unsigned char)img->d;
+    p[37] = (unsigned char)img->codec;
+    wr16(p + 38, img->palcount);
+
+    offset += img->palcount * img->d + (unsigned long)img->payloadLen;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    memcpy(p, images[i].pal, images[i].palcount * images[i].d);
+    p += images[i].palcount * images[i].d;
+    memcpy(p, images[i].payload, images[i].payloadLen);
+    p += images[i].payloadLen;
+  }
+
+  return buf;
+}
+
+/* decode the file the same way Fl_PNG_Image does */
+static int bench_png(const unsigned char *buf, size_t len, unsigned char *out)
+{
+  png_image img;
+
+  memset(&img, 0, sizeof(img));
+  img.version = PNG_IMAGE_VERSION;
+
+  if (!png_image_begin_read_from_memory(&img, buf, len)) {
+    return 0;
+  }
+  img.format = (img.format & PNG_FORMAT_FLAG_ALPHA) ? PNG_FORMAT_RGBA : PNG_FORMAT_RGB;
+
+  if (!png_image_finish_read(&img, NULL, out, 0, NULL)) {
+    png_image_free(&img);
+    return 0;
+  }
+
+  return 1;
+}
+
+static double bench_run(int png, const unsigned char *buf, size_t len,
+                        const assetpack_entry_t *entry, unsigned char *out, long *iterations)
+{
+  clock_t start = clock();
+  clock_t end = start + (clock_t)(BENCH_SECONDS * CLOCKS_PER_SEC);
+  long n = 0;
+
+  do {
+    if (png) {
+      bench_png(buf, len, out);
+    } else {
+      assetpack_decode(buf, len, entry, out);
+    }
+    n++;
+  } while (clock() < end);
+
+  *iterations = n;
+  return (double)(clock() - start) / CLOCKS_PER_SEC / n * 1e6;
+}
+
+static int bench(char **files, int count, image_t *images)
+{
+  unsigned char *pack;
+  size_t packLen;
+  double totalPng = 0, totalGeneric = 0, totalSse2 = 0;
+  long sizePng = 0, sizePack = 0;
+
+  if ((pack = pack_buffer(images, count, &packLen)) == NULL) {
+    return 1;
+  }
+
+  printf("%-20s %10s %10s %12s %12s %12s\n", "image", "png bytes", "pack bytes", "libpng (us)", "generic (us)",
+         cpu_has_sse2() ? "sse2 (us)" : "");
+
+  for (int i = 0; i < count; ++i) {
+    image_t *img = &images[i];
+    assetpack_entry_t e;
+    unsigned char *png, *out, *ref;
+    size_t pngLen, outLen;
+    long n1, n2, n3;
+    double t1, t2, t3 = 0;
+
+    if ((png = read_file(files[i], &pngLen)) == NULL || !assetpack_find(pack, packLen, img->name, &e)) {
+      fprintf(stderr, "error: `%s'\n", files[i]);
+      return 1;
+    }
+
+    outLen = (size_t)img->w * img->h * e.d;
+    out = malloc(outLen);
+    ref = malloc(outLen);
+    t1 = bench_run(1, png, pngLen, NULL, out, &n1);
+
+    cpu_disable_simd(1);
+    t2 = bench_run(0, pack, packLen, &e, ref, &n2);
+    cpu_disable_simd(0);
+
+    if (cpu_has_sse2()) {
+      t3 = bench_run(0, pack, packLen, &e, out, &n3);
+
+      if (memcmp(out, ref, outLen) != 0) {
+        fprintf(stderr, "error: SSE2 and generic decoder differ for `%s'\n", img->name);
+        return 1;
+      }
+    }
+
+    printf("%-20s %10ld %10lu %12.1f %12.1f", img->name, img->pngSize,
+           (unsigned long)(e.palcount * e.d + e.size), t1, t2);
+    if (t3 > 0) {
+      printf(" %12.1f", t3);
+    }
+    putchar('\n');
+
+    totalPng += t1;
+    totalGeneric += t2;
+    totalSse2 += t3;
+    sizePng += img->pngSize;
+    sizePack += (long)(e.palcount * e.d + e.size);
+
+    free(ref);
+    free(out);
+    free(png);
+  }
+
+  printf("%-20s %10ld %10ld %12.1f %12.1f", "total", sizePng, sizePack, totalPng, totalGeneric);
+  if (totalSse2 > 0) {
+    printf(" %12.1f", totalSse2);
+  }
+  putchar('\n');
+  printf("\nThe libpng path additionally links libpng.a and libz.a into the executable.\n");
+
+  free(pack);
+  return 0;
+}
+
+static int cmd_image(const char *in, const char *out)
+{
+  char hashFile[4096];
+  char hashStr[32];
+  unsigned char *png, *buf;
+  unsigned long long h = 0xCBF29CE484222325ULL;
+  size_t len, oldLen;
+  image_t img;
+  int rv;
+
+  if ((png = read_file(in, &len)) == NULL) {
+    fprintf(stderr, "error: cannot read file `%s'\n", in);
+    return 1;
+  }
+
+  h = hash_bytes(h, (const unsigned char *)ENCODER_VERSION, sizeof(ENCODER_VERSION));
+  h = hash_bytes(h, png, len);
+  free(png);
+
+  snprintf(hashFile, sizeof(hashFile), "%s.hash", out);
+  snprintf(hashStr, sizeof(hashStr), "%016llx\n", h);
+
+  /* input didn't change and the output still exists -> nothing to do */
+  if ((buf = read_file(hashFile, &oldLen)) != NULL) {
+    int same = (oldLen == strlen(hashStr) && memcmp(buf, hashStr, oldLen) == 0);
+    free(buf);
+
+    if (same && (buf = read_file(out, &oldLen)) != NULL) {
+      free(buf);
+      return 0;
+    }
+  }
+
+  if (!load_png(in, &img)) {
+    return 1;
+  }
+  pack_image(&img);
+
+  if ((buf = pack_buffer(&img, 1, &len)) == NULL) {
+    return 1;
+  }
+
+  rv = write_if_changed(out, buf, len) && write_if_changed(hashFile, hashStr, strlen(hashStr));
+  free(buf);
+
+  return rv ? 0 : 1;
+}
+
+/* names of the rows in lang.txt; the row number is the string ID, so rows
+ * may only be appended.  Names starting with '0' are not used by the launcher. */
+static const char *ui_names[] = {
+  "Settings",
+  "0GraphicsSettings",
+  "GraphicsDevice",
+  "Resolution",
+  "Fullscreen",
+  "0AudioSettings",
+  "0OutputDevice",
+  "Language",
+  "ControllerSelection",
+  "0AdditionalController",
+  "0ControllerNumber",
+  "0Layout",
+  "0ConfigurationLayout",
+  "Movement",
+  "Action",
+  "Up",
+  "Down",
+  "Left",
+  "Right",
+  "Jump",
+  "Start",
+  "SaveSettings",
+  "Player",
+  "Select",
+  "Back",
+  "Keyboard",
+  "Gamepad",
+  "ScoreAttack",
+  "Press",
+  "ResetToDefault",
+  "0Configuration",
+  "0ConfigurationSaved",
+  "SuperSonic",
+  "Vibrate",
+  "0Leaderboards",
+  "LanguageName",
+  NULL
+};
+
+#define UI_COUNT  (sizeof(ui_names) / sizeof(*ui_names) - 1)
+
+typedef struct {
+  char *cell[UI_COUNT][64];  /* [row][column] */
+  unsigned columns;
+  unsigned char *txt;
+} lang_table_t;
+
+/* split lang.txt into rows separated by newlines and columns separated by '|' */
+static int parse_lang(const char *in, lang_table_t *t)
+{
+  size_t len, row = 0;
+  char *p;
+
+  memset(t, 0, sizeof(*t));
+
+  if ((t->txt = read_file(in, &len)) == NULL || len == 0) {
+    fprintf(stderr, "error: cannot read file `%s'\n", in);
+    return 0;
+  }
+
+  t->txt = realloc(t->txt, len + 1);
+  t->txt[len] = 0;
+  p = (char *)t->txt;
+
+  while (*p) {
+    char *eol = p + strcspn(p, "\n");
+    char *next = *eol ? eol + 1 : eol;
+    unsigned col = 0;
+
+    *eol = 0;
+    if (eol > p && eol[-1] == '\r') {
+      eol[-1] = 0;
+    }
+
+    if (*p == 0) {
+      p = next;
+      continue;  /* empty line */
+    }
+
+    if (row >= UI_COUNT) {
+      fprintf(stderr, "error: `%s' has more than %u rows\n", in, (unsigned)UI_COUNT);
+      return 0;
+    }
+
+    for (char *c = p; ; c = strchr(c, '|') + 1) {
+      if (col == sizeof(t->cell[0]) / sizeof(*t->cell[0])) {
+        fprintf(stderr, "error: `%s' row %u has too many columns\n", in, (unsigned)row + 1);
+        return 0;
+      }
+      t->cell[row][col++] = c;
+      if (!strchr(c, '|')) {
+        break;
+      }
+    }
+
+    for (unsigned i = 1; i < col; ++i) {
+      t->cell[row][i][-1] = 0;  /* the '|' */
+    }
+
+    if (row == 0) {
+      t->columns = col;
+    } else if (col != t->columns) {
+      fprintf(stderr, "error: `%s' row %u has %u columns instead of %u\n",
+              in, (unsigned)row + 1, col, t->columns);
+      return 0;
+    }
+
+    row++;
+    p = next;
+  }
+
+  if (row != UI_COUNT) {
+    fprintf(stderr, "error: `%s' has %u rows instead of %u\n", in, (unsigned)row, (unsigned)UI_COUNT);
+    return 0;
+  }
+
+  return 1;
+}
+
+/* append a string to the blob unless it's already in there; returns its offset */
+static unsigned long intern(char *blob, size_t *blobLen, const char *s)
+{
+  size_t len = strlen(s) + 1;
+
+  for (size_t i = 0; i < *blobLen; i += strlen(blob + i) + 1) {
+    if (memcmp(blob + i, s, len) == 0) {
+      return (unsigned long)i;
+    }
+  }
+
+  memcpy(blob + *blobLen, s, len);
+  *blobLen += len;
+
+  return (unsigned long)(*blobLen - len);
+}
+
+/* "SettingsDevice" -> "SETTINGS_DEVICE" */
+static char *enum_name(char *p, const char *name)
+{
+  for (const char *c = name; *c; ++c) {
+    if (c > name && *c >= 'A' && *c <= 'Z' && c[-1] >= 'a' && c[-1] <= 'z') {
+      *p++ = '_';
+    }
+    *p++ = (char)((*c >= 'a' && *c <= 'z') ? *c - 'a' + 'A' : *c);
+  }
+  return p;
+}
+
+/* write a C string literal; escaped bytes end the literal so that a
+ * following hex digit isn't taken as part of the escape sequence */
+static char *c_string(char *p, const char *s, size_t len)
+{
+  int hex = 0;
+
+  *p++ = '"';
+
+  for (size_t i = 0; i < len; ++i) {
+    unsigned char c = (unsigned char)s[i];
+
+    if (c >= ' ' && c <= '~' && c != '"' && c != '\\') {
+      if (hex) {
+        p += sprintf(p, "\" \"");
+      }
+      *p++ = (char)c;
+      hex = 0;
+    } else {
+      p += sprintf(p, "\\x%02X", c);
+      hex = 1;
+    }
+  }
+
+  *p++ = '"';
+  return p;
+}
+
+/* lang.h: the string ID enum and, for the file that defines UI_STRINGS_DATA,
+ * every string once in a single blob plus an offset table per language */
+static int cmd_lang(const char *in, const char *out)
+{
+  lang_table_t t;
+  unsigned long (*offsets)[UI_COUNT];
+  char *blob, *buf, *p;
+  size_t blobLen = 0, total = 0;
+  int rv;
+
+  if (!parse_lang(in, &t)) {
+    free(t.txt);
+    return 1;
+  }
+
+  for (size_t i = 0; i < UI_COUNT; ++i) {
+    for (unsigned j = 0; j < t.columns; ++j) {
+      total += strlen(t.cell[i][j]) + 1;
+    }
+  }
+
+  blob = malloc(total);
+  offsets = malloc(t.columns * sizeof(*offsets));
+
+  for (unsigned j = 0; j < t.columns; ++j) {
+    for (size_t i = 0; i < UI_COUNT; ++i) {
+      offsets[j][i] = intern(blob, &blobLen, t.cell[i][j]);
+    }
+  }
+
+  /* worst case is "\xNN" for every byte */
+  p = buf = malloc(blobLen * 8 + t.columns * UI_COUNT * 16 + UI_COUNT * 64 + 4096);
+
+  p += sprintf(p, "/* generated by assetc from lang.txt, do not edit */\n\n"
+                  "#ifndef LANG_H\n"
+                  "#define LANG_H\n\n"
+                  "#define UI_LANGUAGES  %u\n\n"
+                  "enum ui_id {\n", t.columns);
+
+  for (size_t i = 0; i < UI_COUNT; ++i) {
+    p += sprintf(p, "  UI_");
+    p = enum_name(p, ui_names[i] + (ui_names[i][0] == '0'));
+    p += sprintf(p, ",%s\n", (ui_names[i][0] == '0') ? "  /* unused */" : "");
+  }
+
+  p += sprintf(p, "  UI_COUNT\n"
+                  "};\n\n"
+                  "#endif  /* LANG_H */\n\n"
+                  "#ifdef UI_STRINGS_DATA\n\n"
+                  "/* %u strings, %u bytes; every string is only stored once */\n"
+                  "static const char ui_blob[] =\n",
+                  (unsigned)(t.columns * UI_COUNT), (unsigned)blobLen);
+
+  for (size_t i = 0; i < blobLen; i += strlen(blob + i) + 1) {
+    p += sprintf(p, "  ");
+    p = c_string(p, blob + i, strlen(blob + i) + 1);
+    *p++ = '\n';
+  }
+
+  p += sprintf(p, "  ;\n\n"
+                  "static const uint32_t ui_offsets[UI_LANGUAGES][UI_COUNT] = {\n");
+
+  for (unsigned j = 0; j < t.columns; ++j) {
+    p += sprintf(p, "  {");
+    for (size_t i = 0; i < UI_COUNT; ++i) {
+      p += sprintf(p, "%s%lu", (i % 12 == 0) ? "\n    " : " ", offsets[j][i]);
+      if (i + 1 < UI_COUNT) {
+        *p++ = ',';
+      }
+    }
+    p += sprintf(p, "\n  },\n");
+  }
+
+  p += sprintf(p, "};\n\n"
+                  "#endif  /* UI_STRINGS_DATA */\n");
+
+  rv = write_if_changed(out, buf, (size_t)(p - buf));
+  free(buf);
+  free(offsets);
+  free(blob);
+  free(t.txt);
+
+  return rv ? 0 : 1;
+}
+
+/* a language pack with one column of a translation table (see ui_strings.hpp) */
+static int cmd_langpack(const char *in, const char *column, const char *out)
+{
+  lang_table_t t;
+  unsigned char *buf, *p;
+  char *blob;
+  size_t blobLen = 0, total = 0, len;
+  unsigned col = (unsigned)atoi(column);
+  int rv;
+
+  if (!parse_lang(in, &t)) {
+    free(t.txt);
+    return 1;
+  }
+
+  if (col >= t.columns) {
+    fprintf(stderr, "error: `%s' has no column %u\n", in, col);
+    free(t.txt);
+    return 1;
+  }
+
+  for (size_t i = 0; i < UI_COUNT; ++i) {
+    total += strlen(t.cell[i][col]) + 1;
+  }
+
+  len = 12 + UI_COUNT * 4 + total;
+  p = buf = calloc(1, len);
+  blob = (char *)buf + 12 + UI_COUNT * 4;
+
+  memcpy(p, "SLL\x01", 4);
+  wr32(p + 4, (unsigned long)UI_COUNT);
+  p += 12;
+
+  for (size_t i = 0; i < UI_COUNT; ++i, p += 4) {
+    wr32(p, intern(blob, &blobLen, t.cell[i][col]));
+  }
+
+  wr32(buf + 8, (unsigned long)blobLen);
+  len = 12 + UI_COUNT * 4 + blobLen;
+
+  rv = write_if_changed(out, buf, len);
+  free(buf);
+  free(t.txt);
+
+  return rv ? 0 : 1;
+}
+
+static void usage(const char *self)
+{
+  fprintf(stderr, "usage: %s image input.png output.bin\n"
+                  "       %s lang lang.txt lang.h\n"
+                  "       %s langpack table.txt column output.lang\n"
+                  "       %s -bench input.png [input.png ...]\n", self, self, self, self);
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc >= 4 && strcmp(argv[1], "image") == 0) {
+    return cmd_image(argv[2], argv[3]);
+  } else if (argc >= 4 && strcmp(argv[1], "lang") == 0) {
+    return cmd_lang(argv[2], argv[3]);
+  } else if (argc >= 5 && strcmp(argv[1], "langpack") == 0) {
+    return cmd_langpack(argv[2], argv[3], argv[4]);
+  } else if (argc >= 3 && strcmp(argv[1], "-bench") == 0) {
+    int count = argc - 2;
+    image_t *images = calloc((size_t)count, sizeof(image_t));
+
+    for (int i = 0; i < count; ++i) {
+      if (!load_png(argv[i + 2], &images[i])) {
+        return 1;
+      }
+      pack_image(&images[i]);
+    }
+    return bench(argv + 2, count, images);
+  }
+
+  usage(argv[0]);
+  return 1;
+}
@@ -0,0 +1,350 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "assetpack.h"
+#include "cpu.h"
+
+#define RD16(x)  ((uint16_t)((x)[0] | (x)[1] << 8))
+#define RD32(x)  ((uint32_t)((x)[0] | (x)[1] << 8 | (x)[2] << 16 | (uint32_t)(x)[3] << 24))
+
+
+int assetpack_find(const uint8_t *pack, size_t packLen, const char *name, assetpack_entry_t *entry)
+{
+	const uint8_t *p;
+	uint16_t count;
+
+	if (packLen < ASSETPACK_HEADER_SIZE || memcmp(pack, ASSETPACK_MAGIC, 4) != 0 ||
+		RD16(pack + 4) != ASSETPACK_VERSION)
+	{
+		return 0;
+	}
+
+	count = RD16(pack + 6);
+
+	if (packLen < ASSETPACK_HEADER_SIZE + (size_t)count * ASSETPACK_ENTRY_SIZE) {
+		return 0;
+	}
+
+	p = pack + ASSETPACK_HEADER_SIZE;
+
+	for (uint16_t i = 0; i < count; ++i, p += ASSETPACK_ENTRY_SIZE) {
+		if (strncmp((const char *)p, name, ASSETPACK_NAME_SIZE) != 0) {
+			continue;
+		}
+
+		memcpy(entry->name, p, ASSETPACK_NAME_SIZE);
+		entry->name[ASSETPACK_NAME_SIZE] = 0;
+		entry->offset = RD32(p + 24);
+		entry->size = RD32(p + 28);
+		entry->w = RD16(p + 32);
+		entry->h = RD16(p + 34);
+		entry->d = p[36];
+		entry->codec = p[37];
+		entry->palcount = RD16(p + 38);
+
+		/* make sure all data is inside the pack */
+		if (entry->d == 0 || entry->d > 4 || entry->palcount > 256 ||
+			entry->offset > packLen ||
+			(size_t)entry->palcount * entry->d + entry->size > packLen - entry->offset)
+		{
+			return 0;
+		}
+		return 1;
+	}
+
+	return 0;
+}
+
+/* reads a LZ4 length extension; returns 0 if the input ends early */
+static int lz4_length(const uint8_t **ip, const uint8_t *iend, size_t *len)
+{
+	unsigned b;
+
+	do {
+		if (*ip >= iend) {
+			return 0;
+		}
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255);
+
+	return 1;
+}
+
+/* bounds-checked decoder loop; continues at ip/op so the fast path can hand over the tail */
+static int lz4_decode_safe(const uint8_t *ip, const uint8_t *iend, uint8_t *dst, uint8_t *op, uint8_t *oend)
+{
+	while (ip < iend) {
+		unsigned token = *ip++;
+		size_t len = token >> 4;
+
+		/* literals */
+		if (len == 15 && !lz4_length(&ip, iend, &len)) {
+			return -1;
+		}
+
+		if (len > (size_t)(iend - ip) || len > (size_t)(oend - op)) {
+			return -1;
+		}
+		memcpy(op, ip, len);
+		ip += len;
+		op += len;
+
+		/* the last sequence has no match */
+		if (ip >= iend) {
+			break;
+		}
+
+		/* match */
+		if (iend - ip < 2) {
+			return -1;
+		}
+		size_t offset = RD16(ip);
+		ip += 2;
+
+		if (offset == 0 || offset > (size_t)(op - dst)) {
+			return -1;
+		}
+
+		len = token & 15;
+
+		if (len == 15 && !lz4_length(&ip, iend, &len)) {
+			return -1;
+		}
+		len += 4;
+
+		if (len > (size_t)(oend - op)) {
+			return -1;
+		}
+
+		const uint8_t *match = op - offset;
+
+		if (offset >= len) {
+			memcpy(op, match, len);
+			op += len;
+		} else {
+			/* overlapping copy, used for runs */
+			while (len--) {
+				*op++ = *match++;
+			}
+		}
+	}
+
+	return (int)(op - dst);
+}
+
+#ifdef CPU_X86
+
+/* Same as lz4_decode_safe(), but copies in 16 byte steps and may write up to
+ * 15 bytes past the end of a sequence.  This is only done while there's at
+ * least WILD_MARGIN bytes of room left, the rest is handed over to the safe loop. */
+#define WILD_MARGIN  32
+
+static CPU_TARGET_SSE2 void wildcopy16(uint8_t *op, const uint8_t *src, size_t len)
+{
+	uint8_t *const end = op + len;
+
+	do {
+		_mm_storeu_si128((__m128i *)op, _mm_loadu_si128((const __m128i *)src));
+		op += 16;
+		src += 16;
+	} while (op < end);
+}
+
+static CPU_TARGET_SSE2 int lz4_decode_sse2(const uint8_t *src, size_t srcLen, uint8_t *dst, size_t dstLen)
+{
+	const uint8_t *ip = src;
+	const uint8_t *const iend = src + srcLen;
+	uint8_t *op = dst;
+	uint8_t *const oend = dst + dstLen;
+
+	while (iend - ip > WILD_MARGIN && oend - op > WILD_MARGIN) {
+		const uint8_t *seq = ip;
+		unsigned token = *ip++;
+		size_t len = token >> 4;
+
+		if (len == 15 && !lz4_length(&ip, iend, &len)) {
+			return -1;
+		}
+
+		/* literals, plus the 2 byte offset that must follow them */
+		if (len + 2 + WILD_MARGIN > (size_t)(iend - ip) || len + WILD_MARGIN > (size_t)(oend - op)) {
+			ip = seq;
+			break;
+		}
+		wildcopy16(op, ip, len);
+		ip += len;
+		op += len;
+
+		size_t offset = RD16(ip);
+		ip += 2;
+
+		if (offset == 0 || offset > (size_t)(op - dst)) {
+			return -1;
+		}
+
+		len = token & 15;
+
+		if (len == 15 && !lz4_length(&ip, iend, &len)) {
+			return -1;
+		}
+		len += 4;
+
+		const uint8_t *match = op - offset;
+
+		if (len + WILD_MARGIN > (size_t)(oend - op)) {
+			/* close to the end of the output, copy exactly */
+			if (len > (size_t)(oend - op)) {
+				return -1;
+			}
+			for (size_t i = 0; i < len; ++i) {
+				op[i] = match[i];
+			}
+		} else if (offset >= 16) {
+			wildcopy16(op, match, len);
+		} else if (offset == 1) {
+			memset(op, *match, len);
+		} else {
+			/* short overlapping pattern */
+			for (size_t i = 0; i < len; ++i) {
+				op[i] = match[i];
+			}
+		}
+		op += len;
+	}
+
+	return lz4_decode_safe(ip, iend, dst, op, oend);
+}
+
+#endif  /* CPU_X86 */
+
+int assetpack_lz4_decompress(const uint8_t *src, size_t srcLen, uint8_t *dst, size_t dstLen)
+{
+#ifdef CPU_X86
+	if (cpu_has_sse2()) {
+		return lz4_decode_sse2(src, srcLen, dst, dstLen);
+	}
+#endif
+	return lz4_decode_safe(src, src + srcLen, dst, dst, dst + dstLen);
+}
+
+/* 4 indices are always read before their 16 output bytes are written;
+ * see the comment about the buffer layout in assetpack_decode() */
+static void expand_rgba_generic(uint8_t *out, const uint8_t *idx, size_t n, const uint32_t *lut)
+{
+	size_t i = 0;
+
+	for ( ; i + 4 <= n; i += 4) {
+		uint32_t px[4] = { lut[idx[i]], lut[idx[i + 1]], lut[idx[i + 2]], lut[idx[i + 3]] };
+		memcpy(out + i * 4, px, 16);
+	}
+
+	for ( ; i < n; ++i) {
+		memcpy(out + i * 4, &lut[idx[i]], 4);
+	}
+}
+
+#ifdef CPU_X86
+static CPU_TARGET_SSE2 void expand_rgba_sse2(uint8_t *out, const uint8_t *idx, size_t n, const uint32_t *lut)
+{
+	size_t i = 0;
+
+	for ( ; i + 4 <= n; i += 4) {
+		__m128i px = _mm_set_epi32((int)lut[idx[i + 3]], (int)lut[idx[i + 2]], (int)lut[idx[i + 1]], (int)lut[idx[i]]);
+		_mm_storeu_si128((__m128i *)(out + i * 4), px);
+	}
+
+	for ( ; i < n; ++i) {
+		memcpy(out + i * 4, &lut[idx[i]], 4);
+	}
+}
+#endif
+
+static void expand_rgba(uint8_t *out, const uint8_t *idx, size_t n, const uint32_t *lut)
+{
+#ifdef CPU_X86
+	if (cpu_has_sse2()) {
+		expand_rgba_sse2(out, idx, n, lut);
+		return;
+	}
+#endif
+	expand_rgba_generic(out, idx, n, lut);
+}
+
+int assetpack_decode(const uint8_t *pack, size_t packLen, const assetpack_entry_t *entry, uint8_t *out)
+{
+	const uint8_t *pal = pack + entry->offset;
+	const uint8_t *payload = pal + (size_t)entry->palcount * entry->d;
+	const size_t n = (size_t)entry->w * entry->h;
+	const size_t outLen = n * entry->d;
+	const size_t indexLen = entry->palcount ? n : outLen;
+	uint8_t *idx;
+
+	(void)packLen;
+
+	/* palette indices are decoded into the end of the output buffer and
+	 * then expanded front to back, which never overwrites unread indices */
+	idx = out + (outLen - indexLen);
+
+	if (entry->codec == ASSETPACK_CODEC_RAW) {
+		if (entry->size != indexLen) {
+			return 0;
+		}
+		memcpy(idx, payload, indexLen);
+	} else if (entry->codec == ASSETPACK_CODEC_LZ4) {
+		if (assetpack_lz4_decompress(payload, entry->size, idx, indexLen) != (int)indexLen) {
+			return 0;
+		}
+	} else {
+		return 0;
+	}
+
+	if (entry->palcount == 0) {
+		return 1;
+	}
+
+	if (entry->d == 4) {
+		/* indices outside of the palette map to transparent black */
+		uint32_t lut[256];
+
+		memset(lut, 0, sizeof(lut));
+		memcpy(lut, pal, (size_t)entry->palcount * 4);
+		expand_rgba(out, idx, n, lut);
+	} else {
+		for (size_t i = 0; i < n; ++i) {
+			unsigned k = idx[i];
+
+			if (k >= entry->palcount) {
+				k = 0;
+			}
+			memcpy(out + i * entry->d, pal + k * entry->d, entry->d);
+		}
+	}
+
+	return 1;
+}
@@ -0,0 +1,89 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Pre-decoded image pack.
+ *
+ * The pack is created at build time by assetc from the PNG files in images/.
+ * All images are 8 bit colormapped, so they are stored as palette + indices.
+ * The indices are either compressed with the LZ4 block format or stored raw,
+ * whichever the asset compiler considered cheaper to load.  Decoding is a
+ * single LZ4 pass followed by a palette lookup, libpng and zlib are not
+ * needed at runtime.
+ *
+ * All values are little endian:
+ *
+ *   header:  "SLPK" | uint16 version | uint16 count
+ *   entry:   char name[24] | uint32 offset | uint32 size |
+ *            uint16 w | uint16 h | uint8 d | uint8 codec | uint16 palcount
+ *   data:    palette (palcount * d bytes) | payload (size bytes)
+ *
+ * If palcount is 0 the payload holds w * h * d bytes of pixel data instead
+ * of w * h palette indices.
+ */
+
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ASSETPACK_MAGIC        "SLPK"
+#define ASSETPACK_VERSION      1
+#define ASSETPACK_HEADER_SIZE  8
+#define ASSETPACK_ENTRY_SIZE   40
+#define ASSETPACK_NAME_SIZE    24
+
+#define ASSETPACK_CODEC_RAW    0
+#define ASSETPACK_CODEC_LZ4    1
+
+typedef struct {
+	char name[ASSETPACK_NAME_SIZE + 1];
+	uint32_t offset;
+	uint32_t size;
+	uint16_t w;
+	uint16_t h;
+	uint8_t d;
+	uint8_t codec;
+	uint16_t palcount;
+} assetpack_entry_t;
+
+/* look up an entry by name; returns 0 if it doesn't exist or the pack is broken */
+int assetpack_find(const uint8_t *pack, size_t packLen, const char *name, assetpack_entry_t *entry);
+
+/* decode an entry into out, which must hold w * h * d bytes; returns 0 on error */
+int assetpack_decode(const uint8_t *pack, size_t packLen, const assetpack_entry_t *entry, uint8_t *out);
+
+/* LZ4 block decompression; returns the number of bytes written or -1 on error */
+int assetpack_lz4_decompress(const uint8_t *src, size_t srcLen, uint8_t *dst, size_t dstLen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* ASSETPACK_H */
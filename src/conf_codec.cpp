@@ -0,0 +1,121 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "conf_codec.hpp"
+#include "key_bindings.hpp"
+
+
+bool conf_decode(const uchar *buf, unsigned int screenCount, confData &out)
+{
+	confData d;
+	keyBindings bindings;
+	uchar *p = reinterpret_cast<uchar *>(&d);
+
+	/* the loop is over a constant table and gets unrolled */
+	for (int i = 0; i < CONF_FIELDS; ++i) {
+		const confField &f = confSchema[i];
+		uint32_t v = 0;
+
+		for (int j = f.size - 1; j >= 0; --j) {
+			v = v << 8 | buf[f.offset + j];
+		}
+
+		switch (f.check) {
+		case CONF_CONST:
+			if (v != f.arg) {
+				return false;
+			}
+			continue;
+		case CONF_BOOL:
+			v = (v == 0) ? 0 : 1;
+			break;
+		case CONF_CONTROLS:
+			v = (v == GAMEPAD_CTRLS) ? GAMEPAD_CTRLS : KEYBOARD_CTRLS;
+			break;
+		case CONF_DISPLAY:
+			v = (v < screenCount) ? v : 0;
+			break;
+		case CONF_KEY:
+			/* only the lowest byte is used */
+			v &= 0xFF;
+
+			if (conf_key_ignored(static_cast<uchar>(v))) {
+				v = f.arg;
+			}
+			if (!bindings.add(static_cast<uchar>(v), f.member - offsetof(confData, keys))) {
+				/* duplicate keys */
+				return false;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (f.width == 1) {
+			p[f.member] = static_cast<uchar>(v);
+		} else {
+			uint16_t u = static_cast<uint16_t>(v);
+			memcpy(p + f.member, &u, sizeof(u));
+		}
+	}
+
+	out = d;
+	return true;
+}
+
+void conf_encode(const confData &in, uchar *buf)
+{
+	const uchar *p = reinterpret_cast<const uchar *>(&in);
+
+	for (int i = 0; i < CONF_FIELDS; ++i) {
+		const confField &f = confSchema[i];
+		uint32_t v;
+
+		if (f.width == 0) {
+			v = f.arg;
+		} else if (f.width == 1) {
+			v = p[f.member];
+		} else {
+			uint16_t u;
+			memcpy(&u, p + f.member, sizeof(u));
+			v = u;
+		}
+
+		for (int j = 0; j < f.size; ++j) {
+			buf[f.offset + j] = static_cast<uchar>(v >> (8 * j));
+		}
+	}
+}
+
+void conf_defaults(confData &out)
+{
+	memset(&out, 0, sizeof(out));
+	out.controls = KEYBOARD_CTRLS;
+
+	for (int i = 0; i < CONF_KEYS; ++i) {
+		out.keys[i] = static_cast<uchar>(confSchema[CONF_F_KEYS + i].arg);
+	}
+}
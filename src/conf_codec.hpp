@@ -0,0 +1,243 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Binary format of main.conf.
+ *
+ * The file is a fixed sequence of little-endian fields.  Their layout is
+ * described once in confSchema, together with the rule that validates each
+ * field; conf_decode() and conf_encode() both walk that table, so loading
+ * and saving can't disagree about the layout.  The offsets are checked
+ * against CONF_SIZE at compile time.
+ *
+ * Nothing in here depends on Windows; the key codes are DirectInput scan
+ * codes (DIK_*), checked against dinput.h in configuration_win32.cpp.  The codec
+ * is also built for the build machine by `make bench-core`.
+ */
+
+#ifndef CONF_CODEC_HPP
+#define CONF_CODEC_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned char uchar;
+
+#define KEYBOARD_CTRLS 0
+#define GAMEPAD_CTRLS 1
+
+#define KEYUP 1
+#define KEYDOWN 2
+#define KEYLEFT 3
+#define KEYRIGHT 4
+#define KEYA 5
+#define KEYB 6
+#define KEYX 7
+#define KEYY 8
+#define KEYSTART 9
+
+#define CONF_SIZE   53
+#define CONF_KEYS   9
+#define CONF_MAGIC  20111005
+#define CONF_END    1701
+
+
+/* the settings stored in main.conf */
+typedef struct {
+	uint16_t resW;
+	uint16_t resH;
+	uchar fullscreen;
+	uchar language;
+	uchar controls;
+	uchar vibra;
+	uchar display;
+	uchar keys[CONF_KEYS];  /* in file order, see conf_key_slot() */
+} confData;
+
+/* how a field is validated when it's decoded */
+enum {
+	CONF_CONST,     /* must be `arg', otherwise the file is rejected */
+	CONF_ANY,       /* taken as is */
+	CONF_BOOL,      /* anything but 0 is 1 */
+	CONF_CONTROLS,  /* anything but GAMEPAD_CTRLS is KEYBOARD_CTRLS */
+	CONF_DISPLAY,   /* a display that doesn't exist is 0 */
+	CONF_KEY        /* an ignored key is replaced by `arg', no key may be bound twice */
+};
+
+typedef struct {
+	uint8_t offset;  /* in the file */
+	uint8_t size;    /* in the file */
+	uint8_t member;  /* offsetof() in confData */
+	uint8_t width;   /* size of the member, 0 for constants */
+	uint8_t check;
+	uint32_t arg;
+} confField;
+
+#define CONF_FIELD(off, size, member, check, arg) \
+	{ off, size, static_cast<uint8_t>(offsetof(confData, member)), \
+	  static_cast<uint8_t>(sizeof(static_cast<confData *>(0)->member)), check, arg }
+
+/* the key codes are only one byte, but they are stored as uint32_t */
+#define CONF_KEY_FIELD(off, slot, def) \
+	{ off, 4, static_cast<uint8_t>(offsetof(confData, keys) + slot), 1, CONF_KEY, def }
+
+enum {
+	CONF_F_MAGIC,
+	CONF_F_RESW,
+	CONF_F_RESH,
+	CONF_F_FULLSCREEN,
+	CONF_F_LANGUAGE,
+	CONF_F_CONTROLS,
+	CONF_F_VIBRA,
+	CONF_F_DISPLAY,
+	CONF_F_KEYS,  /* first of CONF_KEYS key fields */
+	CONF_F_END = CONF_F_KEYS + CONF_KEYS,
+	CONF_FIELDS
+};
+
+static constexpr confField confSchema[CONF_FIELDS] = {
+	{ 0, 4, 0, 0, CONF_CONST, CONF_MAGIC },
+	CONF_FIELD(4, 2, resW, CONF_ANY, 0),
+	CONF_FIELD(6, 2, resH, CONF_ANY, 0),
+	CONF_FIELD(8, 1, fullscreen, CONF_BOOL, 0),
+	CONF_FIELD(9, 1, language, CONF_ANY, 0),
+	CONF_FIELD(10, 1, controls, CONF_CONTROLS, 0),
+	CONF_FIELD(11, 1, vibra, CONF_BOOL, 0),
+	CONF_FIELD(12, 1, display, CONF_DISPLAY, 0),
+	CONF_KEY_FIELD(13, 0, 0xCB),  /* left: DIK_LEFT */
+	CONF_KEY_FIELD(17, 1, 0xCD),  /* right: DIK_RIGHT */
+	CONF_KEY_FIELD(21, 2, 0xC8),  /* up: DIK_UP */
+	CONF_KEY_FIELD(25, 3, 0xD0),  /* down: DIK_DOWN */
+	CONF_KEY_FIELD(29, 4, 0x39),  /* jump / select: DIK_SPACE */
+	CONF_KEY_FIELD(33, 5, 0x20),  /* jump / back: DIK_D */
+	CONF_KEY_FIELD(37, 6, 0x1E),  /* score attack: DIK_A */
+	CONF_KEY_FIELD(41, 7, 0x1F),  /* super sonic: DIK_S */
+	CONF_KEY_FIELD(45, 8, 0x1C),  /* start: DIK_RETURN */
+	{ 49, 4, 0, 0, CONF_CONST, CONF_END }
+};
+
+#undef CONF_FIELD
+#undef CONF_KEY_FIELD
+
+/* every field starts where the previous one ended and fits its member */
+constexpr bool conf_schema_valid()
+{
+	unsigned int end = 0;
+
+	for (int i = 0; i < CONF_FIELDS; ++i) {
+		const confField &f = confSchema[i];
+
+		if (f.offset != end || f.size < 1 || f.size > 4 || f.width > f.size) {
+			return false;
+		}
+		if ((f.check == CONF_CONST) != (f.width == 0) || f.member + f.width > sizeof(confData)) {
+			return false;
+		}
+		end += f.size;
+	}
+
+	return end == CONF_SIZE;
+}
+
+static_assert(conf_schema_valid(), "the main.conf schema doesn't add up to CONF_SIZE");
+static_assert(confSchema[CONF_F_MAGIC].arg == CONF_MAGIC && confSchema[CONF_F_END].arg == CONF_END,
+	"the main.conf schema must start with the magic number and end with the end number");
+
+/* index into confData::keys for a KEYxxx type; unknown types are KEYUP */
+constexpr int conf_key_slot(int type)
+{
+	return (type == KEYLEFT) ? 0 :
+		(type == KEYRIGHT) ? 1 :
+		(type == KEYDOWN) ? 3 :
+		(type >= KEYA && type <= KEYSTART) ? type - KEYA + 4 : 2;
+}
+
+/* KEYxxx type of a confData::keys index */
+constexpr int conf_key_type(int slot)
+{
+	return (slot == 0) ? KEYLEFT :
+		(slot == 1) ? KEYRIGHT :
+		(slot == 2) ? KEYUP :
+		(slot == 3) ? KEYDOWN : slot - 4 + KEYA;
+}
+
+constexpr uchar conf_default_key(int type)
+{
+	return static_cast<uchar>(confSchema[CONF_F_KEYS + conf_key_slot(type)].arg);
+}
+
+/* keys that can't be bound (system, media and IME keys) */
+constexpr bool conf_key_ignored(uchar dx)
+{
+	switch (dx) {
+	case 0x01:  /* DIK_ESCAPE */
+	case 0x3A:  /* DIK_CAPITAL */
+	case 0x45:  /* DIK_NUMLOCK */
+	case 0x46:  /* DIK_SCROLL */
+	case 0x70:  /* DIK_KANA */
+	case 0x79:  /* DIK_CONVERT */
+	case 0x7B:  /* DIK_NOCONVERT */
+	case 0x90:  /* DIK_PREVTRACK */
+	case 0x94:  /* DIK_KANJI */
+	case 0x95:  /* DIK_STOP */
+	case 0x99:  /* DIK_NEXTTRACK */
+	case 0xA0:  /* DIK_MUTE */
+	case 0xA1:  /* DIK_CALCULATOR */
+	case 0xA2:  /* DIK_PLAYPAUSE */
+	case 0xA4:  /* DIK_MEDIASTOP */
+	case 0xAE:  /* DIK_VOLUMEDOWN */
+	case 0xB0:  /* DIK_VOLUMEUP */
+	case 0xB2:  /* DIK_WEBHOME */
+	case 0xDB:  /* DIK_LWIN */
+	case 0xDC:  /* DIK_RWIN */
+	case 0xDD:  /* DIK_APPS */
+	case 0xDE:  /* DIK_POWER */
+	case 0xDF:  /* DIK_SLEEP */
+	case 0xE3:  /* DIK_WAKE */
+	case 0xE5:  /* DIK_WEBSEARCH */
+	case 0xE6:  /* DIK_WEBFAVORITES */
+	case 0xE7:  /* DIK_WEBREFRESH */
+	case 0xE8:  /* DIK_WEBSTOP */
+	case 0xE9:  /* DIK_WEBFORWARD */
+	case 0xEA:  /* DIK_WEBBACK */
+	case 0xEB:  /* DIK_MYCOMPUTER */
+	case 0xEC:  /* DIK_MAIL */
+	case 0xED:  /* DIK_MEDIASELECT */
+		return true;
+	}
+
+	return false;
+}
+
+/* decode CONF_SIZE bytes; `out' is only written if the file is valid,
+ * a display index that is not below `screenCount' is reset to 0 */
+bool conf_decode(const uchar *buf, unsigned int screenCount, confData &out);
+
+/* encode into CONF_SIZE bytes */
+void conf_encode(const confData &in, uchar *buf);
+
+/* the default settings; the resolution is left at 0x0 */
+void conf_defaults(confData &out);
+
+#endif  /* CONF_CODEC_HPP */
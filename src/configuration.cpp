@@ -22,368 +22,145 @@
  * SOFTWARE.
  */
 
-#include <windows.h>
-
-#ifndef DIRECTINPUT_VERSION
-#define DIRECTINPUT_VERSION 0x0800
-#endif
-#include <dinput.h>
-
-#include <FL/Fl.H>
-
-#include <algorithm>
-#include <vector>
-#include <ctype.h>
-#include <stdint.h>
-#include <stdio.h>
-#include <wchar.h>
+#include <string.h>
 
 #include "configuration.hpp"
-
-#define CONF_SIZE     53
-#define TO_UINT16(x)  static_cast<uint16_t>(((0xFF & x[0]) << 0 | (0xFF & x[1]) << 8))
-#define TO_UINT32(x)  static_cast<uint32_t>(((0xFF & x[0]) << 0 | (0xFF & x[1]) << 8 | (0xFF & x[2]) << 16 | (0xFF & x[3]) << 24))
+#include "trace.hpp"
 
 
 void configuration::resN(size_t n)
 {
+	if (resList.empty()) {
+		/* still being enumerated */
+		return;
+	}
+
 	if (n <= 0) {
 		n = 0;
 	} else if (n >= resList.size()) {
 		n = resList.size() - 1;
 	}
-	_resW = resList.at(n).w;
-	_resH = resList.at(n).h;
+	_conf.resW = resList.w(n);
+	_conf.resH = resList.h(n);
 	_resN = n;
 }
 
-bool configuration::isIgnoredKey(uchar dx)
+bool configuration::checkConfig(const confChar *filename)
 {
-	switch (dx) {
-	case DIK_APPS:
-	case DIK_CALCULATOR:
-	case DIK_CAPITAL:
-	case DIK_CONVERT:
-	case DIK_ESCAPE:
-	case DIK_KANA:
-	case DIK_KANJI:
-	case DIK_LWIN:
-	case DIK_MAIL:
-	case DIK_MEDIASELECT:
-	case DIK_MEDIASTOP:
-	case DIK_MUTE:
-	case DIK_MYCOMPUTER:
-#ifdef DIK_NEXTTRACK
-	case DIK_NEXTTRACK:
-#endif
-	case DIK_NOCONVERT:
-	case DIK_NUMLOCK:
-	case DIK_PLAYPAUSE:
-	case DIK_POWER:
-#ifdef DIK_PREVTRACK
-	case DIK_PREVTRACK:
-#endif
-	case DIK_RWIN:
-	case DIK_SCROLL:
-	case DIK_SLEEP:
-	case DIK_STOP:
-	case DIK_VOLUMEDOWN:
-	case DIK_VOLUMEUP:
-	case DIK_WAKE:
-	case DIK_WEBBACK:
-	case DIK_WEBFAVORITES:
-	case DIK_WEBFORWARD:
-	case DIK_WEBHOME:
-	case DIK_WEBREFRESH:
-	case DIK_WEBSEARCH:
-	case DIK_WEBSTOP:
-		return true;
-	}
+	uchar buf[CONF_SIZE];
+	confData d;
 
-	return false;
+	/* the display index is only checked by loadConfig() */
+	return (readFile(filename, buf) && conf_decode(buf, 256, d));
 }
 
 bool configuration::loadConfig(void)
 {
-	FILE *fp = NULL;
-	unsigned char buf[CONF_SIZE];
-	unsigned char *p = buf;
-	bool resFound = false;
-	std::vector<uchar> v;
-
-	if (_wfopen_s(&fp, _confFile, L"rb") != 0) {
-		return false;
-	}
-
-	if (fread(&buf, 1, CONF_SIZE, fp) != CONF_SIZE) {
-		fclose(fp);
-		return false;
-	}
-	fclose(fp);
+	_onDiskValid = readFile(_confFile, _onDisk);
 
-	/* magic number */
-	if (TO_UINT32(p) != 20111005) {
-		return false;
-	}
-	p += 4;
-
-	_resW = TO_UINT16(p);
-	p += 2;
-	_resH = TO_UINT16(p);
-	p += 2;
-
-	for (size_t i = 0; i < resList.size(); ++i) {
-		if (_resW == resList.at(i).w && _resH == resList.at(i).h) {
-			_resN = i;
-			resFound = true;
-			break;
-		}
-	}
-
-	if (!resFound) {
-		_resW = resList.at(0).w;
-		_resH = resList.at(0).h;
-		_resN = 0;
-	}
-
-	_fullscreen = (p[0] == 0) ? 0 : 1;
-	_language = p[1];
-	_controls = (p[2] == GAMEPAD_CTRLS) ? GAMEPAD_CTRLS : KEYBOARD_CTRLS;
-	_vibra = (p[3] == 0) ? 0 : 1;
-	_display = (p[4] > _screenCount - 1) ? 0 : p[4];
-	p += 5;
-
-#define GETKEY(var,def) \
-	var=p[0]; \
-	p+=4; \
-	if (isIgnoredKey(var)) { var=def; } \
-	v.push_back(var);
-
-	GETKEY(_keyLeft, DIK_LEFT);
-	GETKEY(_keyRight, DIK_RIGHT);
-	GETKEY(_keyUp, DIK_UP);
-	GETKEY(_keyDown, DIK_DOWN);
-	GETKEY(_keyA, DIK_SPACE);
-	GETKEY(_keyB, DIK_D);
-	GETKEY(_keyX, DIK_A);
-	GETKEY(_keyY, DIK_S);
-	GETKEY(_keyStart, DIK_RETURN);
-
-#undef GETKEY
-
-	/* end number */
-	if (TO_UINT32(p) != 1701) {
-		return false;
-	}
-
-	std::sort(v.begin(), v.end());
-	
-	if (std::unique(v.begin(), v.end()) != v.end()) {
-		/* duplicate keys */
+	if (!_onDiskValid || !conf_decode(_onDisk, _screenCount, _conf)) {
 		return false;
 	}
 
+	_bindings.assign(_conf.keys, CONF_KEYS);
+	matchRes();
 	return true;
 }
 
 void configuration::setDefaultKeys(void)
 {
-	_keyLeft = DIK_LEFT;
-	_keyRight = DIK_RIGHT;
-	_keyUp = DIK_UP;
-	_keyDown = DIK_DOWN;
-	_keyA = DIK_SPACE;
-	_keyB = DIK_D;
-	_keyX = DIK_A;
-	_keyY = DIK_S;
-	_keyStart = DIK_RETURN;
+	for (int i = KEYUP; i <= KEYSTART; ++i) {
+		_conf.keys[conf_key_slot(i)] = conf_default_key(i);
+	}
+	_bindings.assign(_conf.keys, CONF_KEYS);
 }
 
-void configuration::loadDefaultConfig(void)
+int configuration::bindKey(uchar dx, int type, bool swap)
 {
-	_resN = 0;
-	_resW = resList.at(_resN).w;
-	_resH = resList.at(_resN).h;
-	_fullscreen = 0;
-	_language = 0;  /* English */
-	_controls = KEYBOARD_CTRLS;
-	_vibra = 0;
-	_display = 0;
-	setDefaultKeys();
+	if (isIgnoredKey(dx)) {
+		return keyOwner(dx);
+	}
+
+	int slot = _bindings.rebind(_conf.keys, conf_key_slot(type), dx, swap);
+	return (slot == -1) ? 0 : conf_key_type(slot);
 }
 
-bool configuration::saveConfig(void)
+void configuration::loadDefaultConfig(void)
 {
-	FILE *fp = NULL;
+	conf_defaults(_conf);  /* English, keyboard */
+	_bindings.assign(_conf.keys, CONF_KEYS);
 
-	if (_wfopen_s(&fp, _confFile, L"wb") != 0) {
-		return false;
-	}
-
-	/* magic number (20111005) */
-	putc(0x9D, fp);
-	putc(0xDE, fp);
-	putc(0x32, fp);
-	putc(0x01, fp);
-
-	putc(static_cast<uchar>(_resW), fp);
-	putc(static_cast<uchar>(_resW >> 8), fp);
-	putc(static_cast<uchar>(_resH), fp);
-	putc(static_cast<uchar>(_resH >> 8), fp);
-
-	putc(_fullscreen, fp);
-	putc(_language, fp);
-	putc(_controls, fp);
-	putc(_vibra, fp);
-	putc(_display, fp);
-
-	/* the DIK_* values don't exceed 255, so it's not a real uint32_t value */
-#define SETKEY(x)  putc(x, fp); putc(0x00, fp); putc(0x00, fp); putc(0x00, fp);
-
-	SETKEY(_keyLeft);
-	SETKEY(_keyRight);
-	SETKEY(_keyUp);
-	SETKEY(_keyDown);
-	SETKEY(_keyA);
-	SETKEY(_keyB);
-	SETKEY(_keyX);
-	SETKEY(_keyY);
-	SETKEY(_keyStart);
-
-#undef SETKEY
-
-	/* end number (1701) */
-	putc(0xA5, fp);
-	putc(0x06, fp);
-	putc(0x00, fp);
-	putc(0x00, fp);
-
-	fclose(fp);
-	return true;
+	_resN = 0;
+	_conf.resW = resList.empty() ? 0 : resList.w(_resN);
+	_conf.resH = resList.empty() ? 0 : resList.h(_resN);
 }
 
-/* get key */
-uchar configuration::key(int type)
+bool configuration::dirty(void)
 {
-	switch (type)
-	{
-	case KEYUP:
-		return _keyUp;
-	case KEYDOWN:
-		return _keyDown;
-	case KEYLEFT:
-		return _keyLeft;
-	case KEYRIGHT:
-		return _keyRight;
-	case KEYA:
-		return _keyA;
-	case KEYB:
-		return _keyB;
-	case KEYX:
-		return _keyX;
-	case KEYY:
-		return _keyY;
-	case KEYSTART:
-		return _keyStart;
-	default:
-		break;
-	}
+	uchar buf[CONF_SIZE];
 
-	return _keyUp;
+	conf_encode(_conf, buf);
+	return (!_onDiskValid || memcmp(buf, _onDisk, CONF_SIZE) != 0);
 }
 
-/* set key */
-void configuration::key(uchar n, int type)
+bool configuration::saveConfig(void)
 {
-	switch (type)
-	{
-	case KEYUP:
-		_keyUp = n;
-		break;
-	case KEYDOWN:
-		_keyDown = n;
-		break;
-	case KEYLEFT:
-		_keyLeft = n;
-		break;
-	case KEYRIGHT:
-		_keyRight = n;
-		break;
-	case KEYA:
-		_keyA = n;
-		break;
-	case KEYB:
-		_keyB = n;
-		break;
-	case KEYX:
-		_keyX = n;
-		break;
-	case KEYY:
-		_keyY = n;
-		break;
-	case KEYSTART:
-		_keyStart = n;
-		break;
-	default:
-		break;
+	uchar buf[CONF_SIZE];
+
+	conf_encode(_conf, buf);
+
+	if (_onDiskValid && memcmp(buf, _onDisk, CONF_SIZE) == 0) {
+		trace_instant("saveConfig unchanged");
+		return true;
 	}
-}
 
-bool configuration::compareRes(res_t a, res_t b) {
-	return (a.w * a.h) > (b.w * b.h);
-}
+	TraceScope ts("saveConfig");
 
-bool configuration::predRes(res_t a, res_t b) {
-	return (a.w == b.w && a.h == b.h);
+	if (!writeFile(_confFile, buf)) {
+		return false;
+	}
+
+	memcpy(_onDisk, buf, CONF_SIZE);
+	_onDiskValid = true;
+	return true;
 }
 
-void configuration::initReslist(void)
+/* find the index of the configured resolution or fall back to the
+ * preferred one, then to the first one */
+void configuration::matchRes(uint32_t preferred)
 {
-	DISPLAY_DEVICEA dd;
-	DEVMODEA dm;
-	char *name = NULL;
+	int n = resList.find(_conf.resW, _conf.resH);
 
-	if (_screenCount > 1) {
-		memset(&dd, 0, sizeof(dd));
-		dd.cb = sizeof(dd);
-
-		if (EnumDisplayDevicesA(NULL, _display, &dd, EDD_GET_DEVICE_INTERFACE_NAME)) {
-			name = dd.DeviceName;
-		}
+	if (n == -1 && preferred != 0) {
+		n = resList.find(MODE_W(preferred), MODE_H(preferred));
 	}
 
-	memset(&dm, 0, sizeof(dm));
-	dm.dmSize = sizeof(dm);
-
-	resList.erase(resList.begin(), resList.end());
-
-	for (int i=0; EnumDisplaySettingsA(name, i, &dm); ++i) {
-		res_t res;
-		res.w = static_cast<uint16_t>(dm.dmPelsWidth);
-		res.h = static_cast<uint16_t>(dm.dmPelsHeight);
-		_snprintf_s(res.l, sizeof(res.l) - 1, "%dx%d", res.w, res.h);
-		resList.push_back(res);
+	if (n != -1) {
+		_resN = static_cast<size_t>(n);
+		_conf.resW = resList.w(_resN);
+		_conf.resH = resList.h(_resN);
+		return;
 	}
 
-	std::sort(resList.begin(), resList.end(), compareRes);
-	auto last = std::unique(resList.begin(), resList.end(), predRes);
+	_resN = 0;
 
-	if (last != resList.end()) {
-		resList.erase(last, resList.end());
+	if (!resList.empty()) {
+		_conf.resW = resList.w(0);
+		_conf.resH = resList.h(0);
 	}
 }
 
-configuration::configuration(const wchar_t *filename)
+void configuration::setReslist(const modeTable &list, uint32_t preferred)
 {
-	_confFile = filename;
-	_screenCount = static_cast<uchar>(Fl::screen_count());
+	resList = list;
+	matchRes(preferred);
+}
 
-	if (_screenCount == 0) {
-		_screenCount = 1;
-	}
+configuration::configuration(const confChar *filename)
+{
+	_confFile = filename;
 
-	initReslist();
-	//res_t r = { 0, 0, "" };
-	//resList.push_back(r);
+	/* the display count is set with screenCount() and
+	 * the resolution list is filled by initReslist() or setReslist() */
 }
 
@@ -22,95 +22,124 @@
  * SOFTWARE.
  */
 
-#include <vector>
-#include <stdint.h>
-#include <wchar.h>
-
-#define KEYBOARD_CTRLS 0
-#define GAMEPAD_CTRLS 1
+#ifndef CONFIGURATION_HPP
+#define CONFIGURATION_HPP
 
-#define KEYUP 1
-#define KEYDOWN 2
-#define KEYLEFT 3
-#define KEYRIGHT 4
-#define KEYA 5
-#define KEYB 6
-#define KEYX 7
-#define KEYY 8
-#define KEYSTART 9
+#include <stdint.h>
 
-typedef unsigned char uchar;
+#include "conf_codec.hpp"
+#include "key_bindings.hpp"
+#include "mode_table.hpp"
 
-typedef struct {
-	uint16_t w;
-	uint16_t h;
-	char l[32];
-} res_t;
+/* file names are UTF-16 on Windows and plain bytes everywhere else */
+#ifdef _WIN32
+typedef wchar_t confChar;
+#else
+typedef char confChar;
+#endif
 
 
 class configuration
 {
 public:
-	std::vector<res_t> resList;
+	modeTable resList;
 
 private:
-	const wchar_t *_confFile = NULL;
+	const confChar *_confFile = NULL;
 
-	uchar _screenCount = 0;
+	uchar _screenCount = 1;
 	size_t _resN = 0;
-	uint16_t _resW = 0;
-	uint16_t _resH = 0;
-
-	uchar _fullscreen = 0;
-	uchar _language = 0;
-	uchar _controls = 0;
-	uchar _vibra = 0;
-	uchar _display = 0;
-	uchar _keyLeft = 0;
-	uchar _keyRight = 0;
-	uchar _keyUp = 0;
-	uchar _keyDown = 0;
-	uchar _keyA = 0;
-	uchar _keyB = 0;
-	uchar _keyX = 0;
-	uchar _keyY = 0;
-	uchar _keyStart = 0;
-
-	static bool compareRes(res_t a, res_t b);
-	static bool predRes(res_t a, res_t b);
+
+	/* what is stored in main.conf */
+	confData _conf = {};
+
+	/* which action each key in _conf.keys is bound to */
+	keyBindings _bindings;
+
+	/* the bytes of main.conf as last read or written; saveConfig()
+	 * skips the write if they wouldn't change */
+	uchar _onDisk[CONF_SIZE];
+	bool _onDiskValid = false;
+
+	void matchRes(uint32_t preferred = 0);
+
+	/* platform parts (configuration_win32.cpp, configuration_posix.cpp) */
+	static bool readFile(const confChar *filename, uchar *buf);
+	static bool writeFile(const confChar *filename, const uchar *buf);
 
 public:
-	configuration(const wchar_t *filename);
+	configuration(const confChar *filename);
 
 	bool loadConfig();
+
+	/* check if the file would be loaded successfully by loadConfig(), without
+	 * enumerating the displays (used by -QuickBoot) */
+	static bool checkConfig(const confChar *filename);
 	void setDefaultKeys();
 	void loadDefaultConfig();
+
+	/* write main.conf if the settings changed; the new file is written to
+	 * a temporary file and then moved over the old one, so a crash while
+	 * saving leaves either the old or the new file */
 	bool saveConfig();
 
+	/* true if saveConfig() would write the file */
+	bool dirty();
+
 	uchar screenCount() { return _screenCount; }
-	static bool isIgnoredKey(uchar dx);
-	void initReslist(void);
+	void screenCount(uchar n) { _screenCount = (n == 0) ? 1 : n; }
+	static bool isIgnoredKey(uchar dx) { return conf_key_ignored(dx); }
+
+#ifdef _WIN32
+	/* enumerate and deduplicate the modes of a display device
+	 * (NULL for the default display); thread-safe */
+	static void enumModes(const char *deviceName, modeTable &list);
+#endif
+
+	/* display whose modes belong into resList (only one list on single screen setups) */
+	uchar reslistDisplay() { return (_screenCount > 1) ? _conf.display : 0; }
+
+#ifdef _WIN32
+	/* fill resList synchronously for the device of reslistDisplay() */
+	void initReslist(const char *deviceName);
+#endif
+
+	/* use a list from enumModes() and look up the configured resolution in it;
+	 * if it's not supported, `preferred' (a MODE_KEY()) is used if possible */
+	void setReslist(const modeTable &list, uint32_t preferred = 0);
 
 	/* get config values */
 	size_t resN()      { return _resN; }
-	uint16_t resW()    { return _resW; }
-	uint16_t resH()    { return _resH; }
-	uchar fullscreen() { return _fullscreen; }
-	uchar language()   { return _language; }
-	uchar controls()   { return _controls; }
-	uchar vibra()      { return _vibra; }
-	uchar display()    { return _display; }
-	uchar key(int type);
+	uint16_t resW()    { return _conf.resW; }
+	uint16_t resH()    { return _conf.resH; }
+	uchar fullscreen() { return _conf.fullscreen; }
+	uchar language()   { return _conf.language; }
+	uchar controls()   { return _conf.controls; }
+	uchar vibra()      { return _conf.vibra; }
+	uchar display()    { return _conf.display; }
+	uchar key(int type) { return _conf.keys[conf_key_slot(type)]; }
 
 	/* set config values */
 	void resN(size_t n);
-	void resW(uint16_t n)    { _resW = n; }
-	void resH(uint16_t n)    { _resH = n; }
-	void fullscreen(uchar n) { _fullscreen = n; }
-	void language(uchar n)   { _language = n; }
-	void controls(uchar n)   { _controls = n; }
-	void vibra(uchar n)      { _vibra = n; }
-	void display(uchar n)    { _display = n; }
-	void key(uchar n, int type);
+	void resW(uint16_t n)    { _conf.resW = n; }
+	void resH(uint16_t n)    { _conf.resH = n; }
+	void fullscreen(uchar n) { _conf.fullscreen = n; }
+	void language(uchar n)   { _conf.language = n; }
+	void controls(uchar n)   { _conf.controls = n; }
+	void vibra(uchar n)      { _conf.vibra = n; }
+	void display(uchar n)    { _conf.display = n; }
+	void key(uchar n, int type) { bindKey(n, type, false); }
+
+	/* the action (KEYxxx) that a key is bound to, or 0 */
+	int keyOwner(uchar dx) {
+		int slot = _bindings.owner(dx);
+		return (slot == -1) ? 0 : conf_key_type(slot);
+	}
+
+	/* bind a key to an action and return the action that had it before (0 if
+	 * none); if it's another one, it gets the old key of `type' if `swap' is
+	 * set, otherwise nothing is changed.  Ignored keys are never bound. */
+	int bindKey(uchar dx, int type, bool swap);
 };
 
+#endif  /* CONFIGURATION_HPP */
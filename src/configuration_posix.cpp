@@ -0,0 +1,87 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "configuration.hpp"
+
+
+/* one read of the whole file */
+bool configuration::readFile(const confChar *filename, uchar *buf)
+{
+	FILE *fp = fopen(filename, "rb");
+
+	if (!fp) {
+		return false;
+	}
+
+	size_t n = fread(buf, 1, CONF_SIZE, fp);
+	fclose(fp);
+
+	return (n == CONF_SIZE);
+}
+
+bool configuration::writeFile(const confChar *filename, const uchar *buf)
+{
+	std::string tmp(filename);
+	std::string dir(filename);
+	size_t slash = dir.rfind('/');
+	ssize_t written;
+
+	tmp += ".tmp";
+	dir = (slash == std::string::npos) ? "." : dir.substr(0, slash + 1);
+
+	int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+	if (fd == -1) {
+		return false;
+	}
+
+	do {
+		written = write(fd, buf, CONF_SIZE);
+	} while (written == -1 && errno == EINTR);
+
+	/* the data must be on the disk before the file is renamed */
+	bool ok = (written == CONF_SIZE && fsync(fd) == 0);
+	ok = (close(fd) == 0) && ok;
+
+	if (!ok || rename(tmp.c_str(), filename) != 0) {
+		unlink(tmp.c_str());
+		return false;
+	}
+
+	/* and the rename before we report success */
+	if ((fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)) != -1) {
+		fsync(fd);
+		close(fd);
+	}
+
+	return true;
+}
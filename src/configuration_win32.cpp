@@ -0,0 +1,153 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <windows.h>
+
+#ifndef DIRECTINPUT_VERSION
+#define DIRECTINPUT_VERSION 0x0800
+#endif
+#include <dinput.h>
+
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "configuration.hpp"
+#include "startup_cache.hpp"
+#include "trace.hpp"
+
+/* the codec can't include dinput.h */
+static_assert(conf_default_key(KEYLEFT) == DIK_LEFT && conf_default_key(KEYRIGHT) == DIK_RIGHT &&
+	conf_default_key(KEYUP) == DIK_UP && conf_default_key(KEYDOWN) == DIK_DOWN &&
+	conf_default_key(KEYA) == DIK_SPACE && conf_default_key(KEYB) == DIK_D &&
+	conf_default_key(KEYX) == DIK_A && conf_default_key(KEYY) == DIK_S &&
+	conf_default_key(KEYSTART) == DIK_RETURN, "default keys don't match dinput.h");
+
+static_assert(conf_key_ignored(DIK_APPS) && conf_key_ignored(DIK_CALCULATOR) && conf_key_ignored(DIK_CAPITAL) &&
+	conf_key_ignored(DIK_CONVERT) && conf_key_ignored(DIK_ESCAPE) && conf_key_ignored(DIK_KANA) &&
+	conf_key_ignored(DIK_KANJI) && conf_key_ignored(DIK_LWIN) && conf_key_ignored(DIK_MAIL) &&
+	conf_key_ignored(DIK_MEDIASELECT) && conf_key_ignored(DIK_MEDIASTOP) && conf_key_ignored(DIK_MUTE) &&
+	conf_key_ignored(DIK_MYCOMPUTER) && conf_key_ignored(DIK_NOCONVERT) && conf_key_ignored(DIK_NUMLOCK) &&
+	conf_key_ignored(DIK_PLAYPAUSE) && conf_key_ignored(DIK_POWER) && conf_key_ignored(DIK_RWIN) &&
+	conf_key_ignored(DIK_SCROLL) && conf_key_ignored(DIK_SLEEP) && conf_key_ignored(DIK_STOP) &&
+	conf_key_ignored(DIK_VOLUMEDOWN) && conf_key_ignored(DIK_VOLUMEUP) && conf_key_ignored(DIK_WAKE) &&
+	conf_key_ignored(DIK_WEBBACK) && conf_key_ignored(DIK_WEBFAVORITES) && conf_key_ignored(DIK_WEBFORWARD) &&
+	conf_key_ignored(DIK_WEBHOME) && conf_key_ignored(DIK_WEBREFRESH) && conf_key_ignored(DIK_WEBSEARCH) &&
+	conf_key_ignored(DIK_WEBSTOP), "ignored keys don't match dinput.h");
+#ifdef DIK_NEXTTRACK
+static_assert(conf_key_ignored(DIK_NEXTTRACK), "ignored keys don't match dinput.h");
+#endif
+#ifdef DIK_PREVTRACK
+static_assert(conf_key_ignored(DIK_PREVTRACK), "ignored keys don't match dinput.h");
+#endif
+
+
+/* one read of the whole file */
+bool configuration::readFile(const confChar *filename, uchar *buf)
+{
+	FILE *fp = NULL;
+
+	if (_wfopen_s(&fp, filename, L"rb") != 0) {
+		return false;
+	}
+
+	size_t n = fread(buf, 1, CONF_SIZE, fp);
+	fclose(fp);
+
+	return (n == CONF_SIZE);
+}
+
+bool configuration::writeFile(const confChar *filename, const uchar *buf)
+{
+	std::wstring tmp(filename);
+	DWORD written = 0;
+
+	tmp += L".tmp";
+
+	HANDLE h = CreateFileW(tmp.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (h == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	/* the data must be on the disk before the file is renamed */
+	BOOL ok = WriteFile(h, buf, CONF_SIZE, &written, NULL) && written == CONF_SIZE && FlushFileBuffers(h);
+	CloseHandle(h);
+
+	if (!ok || !MoveFileExW(tmp.c_str(), filename, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+		DeleteFileW(tmp.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+/* the modes of a display device as reported by Windows */
+class displaySettings : public modeSource
+{
+private:
+	const char *_deviceName;
+	DEVMODEA _dm;
+
+public:
+	displaySettings(const char *deviceName)
+		: _deviceName(deviceName)
+	{
+		memset(&_dm, 0, sizeof(_dm));
+		_dm.dmSize = sizeof(_dm);
+	}
+
+	/* the same size is reported for every bit depth and refresh rate */
+	bool mode(int i, uint16_t &w, uint16_t &h) {
+		if (!EnumDisplaySettingsA(_deviceName, i, &_dm)) {
+			return false;
+		}
+		w = static_cast<uint16_t>(_dm.dmPelsWidth);
+		h = static_cast<uint16_t>(_dm.dmPelsHeight);
+		return true;
+	}
+};
+
+void configuration::enumModes(const char *deviceName, modeTable &list)
+{
+	displaySettings src(deviceName);
+	list.fill(src);
+}
+
+void configuration::initReslist(const char *deviceName)
+{
+	uchar display = reslistDisplay();
+
+	/* walking all modes with EnumDisplaySettings() is slow */
+	if (!cache_get_reslist(display, resList)) {
+		trace_begin("initReslist");
+		enumModes(deviceName, resList);
+		trace_end("initReslist");
+		cache_put_reslist(display, resList);
+	}
+
+	matchRes();
+}
+
@@ -0,0 +1,695 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Benchmarks of the parts of the launcher that don't depend on Windows or
+ * FLTK, built for the build machine by `make bench-core`.
+ *
+ *   corebench [-runs n] [-count n] [conf|keys|modes|fit|lang ...]
+ *
+ * Every suite first checks its results against the way the launcher did the
+ * same work before (or against invariants where there is no old way) and
+ * fails if they differ.  Then every variant is timed `runs' times (default
+ * 21) and the median and the 95th percentile per item are printed.
+ *
+ * conf   decode and encode `count' (default 1 million) synthetic main.conf
+ *        files: valid ones, ones with ignored or duplicate keys and ones
+ *        with random bytes flipped
+ * keys   check `count' random key captures for conflicts
+ * modes  sort and deduplicate a fake display with 10000 modes
+ * fit    shorten long Latin, accented and Japanese labels
+ * lang   open, check and read synthetic language packs
+ */
+
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "conf_codec.hpp"
+#include "key_bindings.hpp"
+#include "lang_pack.hpp"
+#include "mode_table.hpp"
+#include "text_fit.hpp"
+#include "text_fit_samples.hpp"
+
+#define MAX_RUNS 1001
+#define ARRLEN(x) (sizeof(x) / sizeof(*x))
+
+#define TO_UINT16(x)  static_cast<uint16_t>(((0xFF & x[0]) << 0 | (0xFF & x[1]) << 8))
+#define TO_UINT32(x)  static_cast<uint32_t>(((0xFF & x[0]) << 0 | (0xFF & x[1]) << 8 | (0xFF & x[2]) << 16 | (0xFF & x[3]) << 24))
+
+
+static int runs = 21;
+static size_t count = 1000000;
+static uint32_t seed = 1;
+static unsigned int sum = 0;  /* keeps the compiler from dropping work */
+
+static uint32_t rnd(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static double now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* times of all runs of one variant */
+class timing
+{
+private:
+	double _ms[MAX_RUNS];
+	int _n = 0;
+	double _t0 = 0;
+
+public:
+	void start() { _t0 = now_ms(); }
+	void stop() { _ms[_n++] = now_ms() - _t0; }
+
+	/* print the median and the 95th percentile (nearest rank) per item */
+	void report(const char *name, size_t items) {
+		std::sort(_ms, _ms + _n);
+		double median = _ms[_n / 2] * 1e6 / items;
+		double p95 = _ms[(_n * 95 + 99) / 100 - 1] * 1e6 / items;
+		printf("  %-24s %10.1f %10.1f\n", name, median, p95);
+	}
+};
+
+static void header(const char *what, size_t items, const char *unit)
+{
+	printf("%s: %zu %ss, %d runs (ns per %s, median and p95)\n", what, items, unit, runs, unit);
+}
+
+
+/* conf: configuration::loadConfig() before the schema */
+static bool decode_old(const uchar *buf, unsigned int screenCount, confData &out)
+{
+	const uchar *p = buf;
+	std::vector<uchar> v;
+
+	if (TO_UINT32(buf) != CONF_MAGIC || TO_UINT32((buf + CONF_SIZE - 4)) != CONF_END) {
+		return false;
+	}
+	p += 4;
+
+	out.resW = TO_UINT16(p);
+	p += 2;
+	out.resH = TO_UINT16(p);
+	p += 2;
+
+	out.fullscreen = (p[0] == 0) ? 0 : 1;
+	out.language = p[1];
+	out.controls = (p[2] == GAMEPAD_CTRLS) ? GAMEPAD_CTRLS : KEYBOARD_CTRLS;
+	out.vibra = (p[3] == 0) ? 0 : 1;
+	out.display = (p[4] > screenCount - 1) ? 0 : p[4];
+	p += 5;
+
+	for (int i = 0; i < CONF_KEYS; ++i) {
+		out.keys[i] = p[0];
+		p += 4;
+		if (conf_key_ignored(out.keys[i])) {
+			out.keys[i] = static_cast<uchar>(confSchema[CONF_F_KEYS + i].arg);
+		}
+		v.push_back(out.keys[i]);
+	}
+
+	std::sort(v.begin(), v.end());
+
+	return (std::unique(v.begin(), v.end()) == v.end());
+}
+
+static bool same(const confData &a, const confData &b)
+{
+	return a.resW == b.resW && a.resH == b.resH && a.fullscreen == b.fullscreen &&
+		a.language == b.language && a.controls == b.controls && a.vibra == b.vibra &&
+		a.display == b.display && memcmp(a.keys, b.keys, CONF_KEYS) == 0;
+}
+
+static void conf_generate(uchar *buf, size_t n)
+{
+	for (size_t i = 0; i < n; ++i) {
+		uchar *p = buf + i * CONF_SIZE;
+		uint32_t kind = rnd() % 8;
+		confData d;
+
+		conf_defaults(d);
+		d.resW = static_cast<uint16_t>(rnd());
+		d.resH = static_cast<uint16_t>(rnd());
+		d.fullscreen = static_cast<uchar>(rnd() % 3);
+		d.language = static_cast<uchar>(rnd() % 8);
+		d.controls = static_cast<uchar>(rnd() % 3);
+		d.vibra = static_cast<uchar>(rnd() % 3);
+		d.display = static_cast<uchar>(rnd() % 4);
+
+		if (kind > 0) {
+			/* random keys, some ignored and some bound twice */
+			for (int j = 0; j < CONF_KEYS; ++j) {
+				d.keys[j] = static_cast<uchar>(rnd());
+			}
+		}
+
+		conf_encode(d, p);
+
+		if (kind == 7) {
+			/* flip a few random bytes, sometimes the magic or the end number */
+			for (uint32_t j = rnd() % 4; j > 0; --j) {
+				p[rnd() % CONF_SIZE] ^= static_cast<uchar>(1 + rnd() % 255);
+			}
+		}
+	}
+}
+
+static int bench_conf(void)
+{
+	std::vector<uchar> files(count * CONF_SIZE), out(count * CONF_SIZE);
+	timing tOld, tNew, tEnc;
+	size_t valid = 0;
+
+	conf_generate(&files[0], count);
+
+	/* both parsers agree and decode(encode(x)) == x */
+	for (size_t i = 0; i < count; ++i) {
+		const uchar *p = &files[i * CONF_SIZE];
+		confData a, b, c;
+		uchar enc[CONF_SIZE];
+		unsigned int screens = 1 + i % 3;
+
+		bool okOld = decode_old(p, screens, a);
+		bool okNew = conf_decode(p, screens, b);
+
+		if (okOld != okNew || (okNew && !same(a, b))) {
+			fprintf(stderr, "error: parsers differ on file %zu\n", i);
+			return 1;
+		}
+		if (!okNew) {
+			continue;
+		}
+		valid++;
+
+		conf_encode(b, enc);
+
+		if (!conf_decode(enc, screens, c) || !same(b, c)) {
+			fprintf(stderr, "error: round trip failed on file %zu\n", i);
+			return 1;
+		}
+	}
+
+	for (int r = 0; r < runs; ++r) {
+		confData d;
+
+		tOld.start();
+		for (size_t i = 0; i < count; ++i) {
+			sum += decode_old(&files[i * CONF_SIZE], 2, d) ? d.keys[0] : 0;
+		}
+		tOld.stop();
+
+		tNew.start();
+		for (size_t i = 0; i < count; ++i) {
+			sum += conf_decode(&files[i * CONF_SIZE], 2, d) ? d.keys[0] : 0;
+		}
+		tNew.stop();
+
+		conf_defaults(d);
+		tEnc.start();
+		for (size_t i = 0; i < count; ++i) {
+			d.resW = static_cast<uint16_t>(i);
+			conf_encode(d, &out[i * CONF_SIZE]);
+		}
+		tEnc.stop();
+
+		sum += out[(r * 977) % out.size()];
+	}
+
+	header("main.conf", count, "file");
+	printf("  (%zu valid)\n", valid);
+	tOld.report("decode, old parser", count);
+	tNew.report("decode, schema", count);
+	tEnc.report("encode, schema", count);
+	return 0;
+}
+
+
+/* keys: how a captured key was checked before; all keys with the new one
+ * in place, sorted, must be unique */
+static bool capture_old(uchar *keys, int slot, uchar dx)
+{
+	std::vector<uchar> v;
+
+	for (int i = 0; i < CONF_KEYS; ++i) {
+		v.push_back((i == slot) ? dx : keys[i]);
+	}
+
+	std::sort(v.begin(), v.end());
+
+	if (std::unique(v.begin(), v.end()) != v.end()) {
+		return false;
+	}
+	keys[slot] = dx;
+	return true;
+}
+
+static bool capture_new(keyBindings &kb, uchar *keys, int slot, uchar dx)
+{
+	int owner = kb.rebind(keys, slot, dx, false);
+	return (owner == -1 || owner == slot);
+}
+
+static int bench_keys(void)
+{
+	std::vector<uchar> captures(count * 2);
+	timing tOld, tNew;
+	confData a, b;
+	keyBindings kb;
+
+	/* a slot and a key; keys from a small range conflict often */
+	for (size_t i = 0; i < count; ++i) {
+		captures[i * 2] = static_cast<uchar>(rnd() % CONF_KEYS);
+		captures[i * 2 + 1] = static_cast<uchar>((rnd() % 2) ? rnd() : 0x10 + rnd() % 32);
+	}
+
+	conf_defaults(a);
+	conf_defaults(b);
+	kb.assign(b.keys, CONF_KEYS);
+
+	for (size_t i = 0; i < count; ++i) {
+		int slot = captures[i * 2];
+		uchar dx = captures[i * 2 + 1];
+
+		if (capture_old(a.keys, slot, dx) != capture_new(kb, b.keys, slot, dx) ||
+			memcmp(a.keys, b.keys, CONF_KEYS) != 0)
+		{
+			fprintf(stderr, "error: conflict checks differ on capture %zu\n", i);
+			return 1;
+		}
+	}
+
+	for (int r = 0; r < runs; ++r) {
+		conf_defaults(a);
+		tOld.start();
+		for (size_t i = 0; i < count; ++i) {
+			sum += capture_old(a.keys, captures[i * 2], captures[i * 2 + 1]);
+		}
+		tOld.stop();
+
+		conf_defaults(b);
+		kb.assign(b.keys, CONF_KEYS);
+		tNew.start();
+		for (size_t i = 0; i < count; ++i) {
+			sum += capture_new(kb, b.keys, captures[i * 2], captures[i * 2 + 1]);
+		}
+		tNew.stop();
+	}
+
+	header("key captures", count, "capture");
+	tOld.report("vector, sort, unique", count);
+	tNew.report("keyBindings", count);
+	return 0;
+}
+
+
+/* modes: a display that lists every size for several bit depths and
+ * refresh rates, like EnumDisplaySettings() does */
+class fakeDisplay : public modeSource
+{
+private:
+	std::vector<uint32_t> _modes;
+
+public:
+	fakeDisplay(int sizes, int repeat) {
+		for (int i = 0; i < sizes; ++i) {
+			uint16_t w = static_cast<uint16_t>(320 + (i % 100) * 40);
+			uint16_t h = static_cast<uint16_t>(200 + (i / 100) * 24);
+
+			for (int j = 0; j < repeat; ++j) {
+				_modes.push_back(MODE_KEY(w, h));
+			}
+		}
+
+		for (size_t i = _modes.size() - 1; i > 0; --i) {
+			std::swap(_modes[i], _modes[rnd() % (i + 1)]);
+		}
+	}
+
+	size_t size() const { return _modes.size(); }
+
+	bool mode(int i, uint16_t &w, uint16_t &h) {
+		if (i < 0 || static_cast<size_t>(i) >= _modes.size()) {
+			return false;
+		}
+		w = MODE_W(_modes[i]);
+		h = MODE_H(_modes[i]);
+		return true;
+	}
+};
+
+static bool compare_modes(uint32_t a, uint32_t b)
+{
+	uint32_t areaA = static_cast<uint32_t>(MODE_W(a)) * MODE_H(a);
+	uint32_t areaB = static_cast<uint32_t>(MODE_W(b)) * MODE_H(b);
+	return (areaA != areaB) ? areaA > areaB : a > b;
+}
+
+/* a plain list: everything in, sorted, duplicates dropped */
+static void modes_old(fakeDisplay &src, std::vector<uint32_t> &list)
+{
+	uint16_t w, h;
+
+	list.clear();
+
+	for (int i = 0; src.mode(i, w, h); ++i) {
+		list.push_back(MODE_KEY(w, h));
+	}
+
+	std::sort(list.begin(), list.end(), compare_modes);
+	list.erase(std::unique(list.begin(), list.end()), list.end());
+}
+
+static int bench_modes(void)
+{
+	fakeDisplay display(2500, 4);
+	std::vector<uint32_t> list;
+	modeTable table;
+	timing tOld, tFill, tLabel, tFind;
+
+	modes_old(display, list);
+	table.fill(display);
+
+	if (list.size() != table.size()) {
+		fprintf(stderr, "error: %zu modes instead of %zu\n", table.size(), list.size());
+		return 1;
+	}
+
+	for (size_t i = 0; i < list.size(); ++i) {
+		if (table.at(i) != list[i] || table.find(MODE_W(list[i]), MODE_H(list[i])) != static_cast<int>(i)) {
+			fprintf(stderr, "error: mode %zu differs\n", i);
+			return 1;
+		}
+	}
+
+	for (int r = 0; r < runs; ++r) {
+		tOld.start();
+		modes_old(display, list);
+		tOld.stop();
+
+		tFill.start();
+		table.fill(display);
+		tFill.stop();
+
+		tLabel.start();
+		for (size_t i = 0; i < table.size(); ++i) {
+			sum += static_cast<unsigned char>(table.label(i)[0]);
+		}
+		tLabel.stop();
+
+		tFind.start();
+		for (size_t i = 0; i < list.size(); ++i) {
+			sum += static_cast<unsigned int>(table.find(MODE_W(list[i]), MODE_H(list[i])));
+		}
+		tFind.stop();
+	}
+
+	header("display modes", display.size(), "mode");
+	printf("  (%zu different sizes)\n", table.size());
+	tOld.report("vector, sort, unique", display.size());
+	tFill.report("modeTable::fill", display.size());
+	tLabel.report("label", display.size());
+	tFind.report("find", display.size());
+	return 0;
+}
+
+
+/* fit: glyphs of a proportional font without a graphics context */
+class fakeGlyphs : public glyphSource
+{
+public:
+	double advance(unsigned int c, int, int size) {
+		double w = (c < 128) ? 4 + (c % 5) : (c < 0x3000) ? 7 + (c % 3) : 12;
+		return w * size / 12.0;
+	}
+};
+
+/* how labels were shortened before: drop the last character and measure
+ * the whole label again until it fits */
+static int fit_old(const char *text, int limit)
+{
+	char buf[256];
+	snprintf(buf, sizeof(buf), "%s", text);
+
+	while (buf[0] != 0 && text_width(buf, 0, 12) > limit) {
+		int last = 0;
+
+		for (int i = 0; buf[i]; ++i) {
+			if ((buf[i] & 0xC0) != 0x80) {
+				last = i;
+			}
+		}
+		buf[last] = 0;
+
+		/* measure without the glyph cache, like fl_width() */
+		text_fit_clear();
+	}
+
+	return static_cast<int>(strlen(buf));
+}
+
+static int bench_fit(void)
+{
+	const size_t reps = 1000;
+	const size_t items = reps * ARRLEN(textFitSamples) * ARRLEN(textFitLimits);
+	fakeGlyphs glyphs;
+	timing tOld, tCold, tWarm;
+
+	text_fit_source(&glyphs);
+
+	for (size_t i = 0; i < ARRLEN(textFitSamples); ++i) {
+		for (size_t j = 0; j < ARRLEN(textFitLimits); ++j) {
+			if (fit_old(textFitSamples[i], textFitLimits[j]) != text_fit(textFitSamples[i], 0, 12, textFitLimits[j])) {
+				fprintf(stderr, "error: text_fit() and stripping differ on text %zu\n", i);
+				return 1;
+			}
+		}
+	}
+
+	for (int r = 0; r < runs; ++r) {
+		tOld.start();
+		for (size_t k = 0; k < reps / 10; ++k) {
+			for (size_t j = 0; j < ARRLEN(textFitSamples) * ARRLEN(textFitLimits); ++j) {
+				sum += fit_old(textFitSamples[j / ARRLEN(textFitLimits)], textFitLimits[j % ARRLEN(textFitLimits)]);
+			}
+		}
+		tOld.stop();
+
+		tCold.start();
+		for (size_t k = 0; k < reps; ++k) {
+			for (size_t j = 0; j < ARRLEN(textFitSamples) * ARRLEN(textFitLimits); ++j) {
+				text_fit_clear();
+				sum += text_fit(textFitSamples[j / ARRLEN(textFitLimits)], 0, 12, textFitLimits[j % ARRLEN(textFitLimits)]);
+			}
+		}
+		tCold.stop();
+
+		tWarm.start();
+		for (size_t k = 0; k < reps; ++k) {
+			for (size_t j = 0; j < ARRLEN(textFitSamples) * ARRLEN(textFitLimits); ++j) {
+				sum += text_fit(textFitSamples[j / ARRLEN(textFitLimits)], 0, 12, textFitLimits[j % ARRLEN(textFitLimits)]);
+			}
+		}
+		tWarm.stop();
+	}
+
+	header("label fitting", items, "label");
+	tOld.report("strip and measure", items / 10);
+	tCold.report("text_fit, cold", items);
+	tWarm.report("text_fit, warm", items);
+	return 0;
+}
+
+
+/* lang: a pack like `assetc langpack' writes it */
+static void lang_generate(std::vector<uint8_t> &pack, uint32_t strings)
+{
+	std::vector<uint8_t> data;
+	char buf[64];
+
+	pack.assign(LANG_PACK_HEADER + strings * 4, 0);
+	memcpy(&pack[0], LANG_PACK_MAGIC, 4);
+
+	for (uint32_t i = 0; i < strings; ++i) {
+		uint32_t off = static_cast<uint32_t>(data.size());
+		int len = snprintf(buf, sizeof(buf), "String %u \xC3\xA4\xC3\xB6\xC3\xBC %u", i, rnd() % 1000);
+
+		data.insert(data.end(), buf, buf + len + 1);
+
+		for (int j = 0; j < 4; ++j) {
+			pack[LANG_PACK_HEADER + i * 4 + j] = static_cast<uint8_t>(off >> (8 * j));
+		}
+	}
+
+	uint32_t size = static_cast<uint32_t>(data.size());
+
+	for (int j = 0; j < 4; ++j) {
+		pack[4 + j] = static_cast<uint8_t>(strings >> (8 * j));
+		pack[8 + j] = static_cast<uint8_t>(size >> (8 * j));
+	}
+
+	pack.insert(pack.end(), data.begin(), data.end());
+}
+
+static int bench_lang(void)
+{
+	const uint32_t strings = 256;
+	const int packCount = 64;
+	const uint32_t nameId = strings - 1;
+	std::vector<std::vector<uint8_t> > packs(packCount);
+	std::vector<langPack> opened(packCount);
+	timing tOpen, tCheck, tRead;
+	size_t broken = 0;
+
+	for (int i = 0; i < packCount; ++i) {
+		lang_generate(packs[i], strings);
+
+		if (!lang_pack_open(&packs[i][0], packs[i].size(), nameId, opened[i]) || !lang_pack_check(opened[i])) {
+			fprintf(stderr, "error: pack %d was rejected\n", i);
+			return 1;
+		}
+	}
+
+	/* packs with a byte of the header or the offsets changed may only be
+	 * accepted if every string is still inside the pack */
+	for (int i = 0; i < 100000; ++i) {
+		std::vector<uint8_t> p = packs[i % packCount];
+		langPack lp;
+
+		p[rnd() % (LANG_PACK_HEADER + strings * 4)] ^= static_cast<uint8_t>(1 + rnd() % 255);
+
+		if (!lang_pack_open(&p[0], p.size(), nameId, lp) || !lang_pack_check(lp)) {
+			broken++;
+			continue;
+		}
+
+		for (uint32_t j = 0; j < lp.count; ++j) {
+			const char *s = lang_pack_str(lp, j);
+
+			if (s < lp.strings || s >= lp.strings + lp.size) {
+				fprintf(stderr, "error: a broken pack was accepted\n");
+				return 1;
+			}
+		}
+	}
+
+	for (int r = 0; r < runs; ++r) {
+		tOpen.start();
+		for (int i = 0; i < packCount; ++i) {
+			sum += lang_pack_open(&packs[i][0], packs[i].size(), nameId, opened[i]);
+		}
+		tOpen.stop();
+
+		tCheck.start();
+		for (int i = 0; i < packCount; ++i) {
+			sum += lang_pack_check(opened[i]);
+		}
+		tCheck.stop();
+
+		tRead.start();
+		for (int i = 0; i < packCount; ++i) {
+			for (uint32_t j = 0; j < strings; ++j) {
+				sum += static_cast<unsigned char>(lang_pack_str(opened[i], j)[7]);
+			}
+		}
+		tRead.stop();
+	}
+
+	header("language packs", packCount, "pack");
+	printf("  (%u strings each, %zu of 100000 damaged packs rejected)\n", strings, broken);
+	tOpen.report("open", packCount);
+	tCheck.report("check", packCount);
+	tRead.report("read all strings", packCount);
+	return 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+	const struct {
+		const char *name;
+		int (*fn)(void);
+	} suites[] = {
+		{ "conf", bench_conf },
+		{ "keys", bench_keys },
+		{ "modes", bench_modes },
+		{ "fit", bench_fit },
+		{ "lang", bench_lang }
+	};
+	std::vector<int (*)(void)> selected;
+
+	for (int i = 1; i < argc; ++i) {
+		size_t j;
+
+		if (strcmp(argv[i], "-runs") == 0 && i + 1 < argc) {
+			runs = atoi(argv[++i]);
+			continue;
+		} else if (strcmp(argv[i], "-count") == 0 && i + 1 < argc) {
+			count = strtoul(argv[++i], NULL, 10);
+			continue;
+		}
+
+		for (j = 0; j < ARRLEN(suites); ++j) {
+			if (strcmp(argv[i], suites[j].name) == 0) {
+				selected.push_back(suites[j].fn);
+				break;
+			}
+		}
+
+		if (j == ARRLEN(suites)) {
+			fprintf(stderr, "usage: %s [-runs n] [-count n] [conf|keys|modes|fit|lang ...]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (runs < 1 || runs > MAX_RUNS || count == 0) {
+		fprintf(stderr, "error: -runs must be 1 to %d and -count at least 1\n", MAX_RUNS);
+		return 1;
+	}
+
+	if (selected.empty()) {
+		for (size_t j = 0; j < ARRLEN(suites); ++j) {
+			selected.push_back(suites[j].fn);
+		}
+	}
+
+	for (size_t i = 0; i < selected.size(); ++i) {
+		if (selected[i]() != 0) {
+			return 1;
+		}
+	}
+
+	printf("(checksum %u)\n", sum);
+	return 0;
+}
@@ -0,0 +1,69 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "cpu.h"
+
+#if defined(CPU_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(CPU_X86)
+#include <cpuid.h>
+#endif
+
+
+static int sse2 = -1;
+
+
+int cpu_has_sse2(void)
+{
+	if (sse2 != -1) {
+		return sse2;
+	}
+
+#if defined(__x86_64__) || defined(_M_X64)
+	/* part of the baseline */
+	sse2 = 1;
+#elif defined(CPU_X86)
+	unsigned int edx = 0;
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	edx = (unsigned int)info[3];
+#else
+	unsigned int eax, ebx, ecx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+		edx = 0;
+	}
+#endif
+	sse2 = (edx & (1u << 26)) ? 1 : 0;
+#else
+	sse2 = 0;
+#endif
+
+	return sse2;
+}
+
+void cpu_disable_simd(int disable)
+{
+	sse2 = disable ? 0 : -1;
+}
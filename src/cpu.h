@@ -0,0 +1,60 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Runtime CPU feature detection.
+ *
+ * The launcher is built for plain i686 and must keep running on CPUs without
+ * SSE2, so vectorized code paths are compiled with a per-function target
+ * attribute and only called if cpu_has_sse2() says so.
+ */
+
+#ifndef CPU_H
+#define CPU_H
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#define CPU_X86
+#include <emmintrin.h>
+#endif
+
+#if defined(CPU_X86) && defined(__GNUC__)
+#define CPU_TARGET_SSE2  __attribute__((target("sse2")))
+#else
+#define CPU_TARGET_SSE2
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int cpu_has_sse2(void);
+
+/* force the generic code paths, used to benchmark them */
+void cpu_disable_simd(int disable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* CPU_H */
@@ -0,0 +1,486 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <windows.h>
+#include <dbt.h>
+#include <process.h>
+#include <string.h>
+
+#include <FL/Fl.H>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "configuration.hpp"
+#include "display_topology.hpp"
+#include "startup_cache.hpp"
+#include "trace.hpp"
+#include "window_hooks.hpp"
+
+/* seconds; plugging in a monitor or a docking station sends a burst of messages */
+#define REFRESH_DELAY  0.25
+
+
+typedef struct {
+	std::string name;      /* empty for the default display */
+	std::string label;
+	uint64_t id;           /* fingerprint of the adapter and its monitors */
+	uint32_t desktopMode;
+	HANDLE thread;
+	bool ready;  /* set on the main thread */
+	modeTable modes;
+} display_t;
+
+/* An entry that is no longer in this list was removed.  Removed entries are
+ * kept until topology_free(): a worker that is still enumerating when its
+ * display is removed must not write into destroyed memory. */
+static std::vector<display_t *> displays;
+static std::vector<display_t *> removed;
+
+static topology_cb_t callback = NULL;
+static void *callbackData = NULL;
+
+static bool refreshRunning = false;
+static bool refreshPending = false;
+static HANDLE refreshThread = NULL;
+static std::vector<display_t *> *scanned = NULL;  /* handed to apply_cb() */
+
+
+/* FNV-1a */
+static uint64_t hash_bytes(uint64_t h, const void *data, size_t len)
+{
+	const uchar *p = reinterpret_cast<const uchar *>(data);
+
+	for (size_t i = 0; i < len; ++i) {
+		h ^= p[i];
+		h *= 0x100000001B3ULL;
+	}
+	return h;
+}
+
+static uint64_t hash_str(uint64_t h, const char *str)
+{
+	return hash_bytes(h, str, strlen(str) + 1);
+}
+
+static const char *device_name(const display_t *d)
+{
+	return d->name.empty() ? NULL : d->name.c_str();
+}
+
+static int index_of(const display_t *d)
+{
+	auto it = std::find(displays.begin(), displays.end(), d);
+	return (it == displays.end()) ? -1 : static_cast<int>(it - displays.begin());
+}
+
+/* enumerate the adapters attached to the desktop, without their modes;
+ * thread-safe */
+static std::vector<display_t *> *scan(void)
+{
+	std::vector<display_t *> *list = new std::vector<display_t *>;
+	DISPLAY_DEVICEA adapter, monitor;
+	DEVMODEA dm;
+	char buf[256];
+
+	memset(&adapter, 0, sizeof(adapter));
+	adapter.cb = sizeof(adapter);
+
+	for (DWORD i = 0; EnumDisplayDevicesA(NULL, i, &adapter, 0) && list->size() < 0xFF; ++i) {
+		if ((adapter.StateFlags & DISPLAY_DEVICE_ATTACHED_TO_DESKTOP) == 0) {
+			continue;
+		}
+
+		display_t *d = new display_t();
+		std::string monitorName = adapter.DeviceString;
+		uint64_t h = 0xCBF29CE484222325ULL;
+
+		h = hash_str(h, adapter.DeviceName);
+		h = hash_str(h, adapter.DeviceID);
+		h = hash_bytes(h, &adapter.StateFlags, sizeof(adapter.StateFlags));
+
+		memset(&monitor, 0, sizeof(monitor));
+		monitor.cb = sizeof(monitor);
+
+		for (DWORD j = 0; EnumDisplayDevicesA(adapter.DeviceName, j, &monitor, 0); ++j) {
+			if (j == 0) {
+				monitorName = monitor.DeviceString;
+			}
+			h = hash_str(h, monitor.DeviceID);
+		}
+
+		memset(&dm, 0, sizeof(dm));
+		dm.dmSize = sizeof(dm);
+
+		if (EnumDisplaySettingsA(adapter.DeviceName, ENUM_CURRENT_SETTINGS, &dm)) {
+			d->desktopMode = MODE_KEY(dm.dmPelsWidth, dm.dmPelsHeight);
+		}
+
+		_snprintf_s(buf, sizeof(buf), _TRUNCATE, "Display %d (%s)",
+			static_cast<int>(list->size()), monitorName.c_str());
+
+		d->name = adapter.DeviceName;
+		d->label = buf;
+		d->id = h;
+		list->push_back(d);
+	}
+
+	if (list->empty()) {
+		/* let EnumDisplaySettings() pick the default display */
+		display_t *d = new display_t();
+		d->label = "Display 0";
+		list->push_back(d);
+	}
+
+	return list;
+}
+
+/* main thread */
+static void finish(display_t *d)
+{
+	if (d->ready) {
+		return;
+	}
+
+	if (d->thread) {
+		CloseHandle(d->thread);
+		d->thread = NULL;
+	}
+
+	d->ready = true;
+
+	int n = index_of(d);
+
+	if (n == -1) {
+		/* removed while it was enumerating */
+		return;
+	}
+
+	cache_put_reslist(static_cast<uchar>(n), d->modes);
+
+	if (callback) {
+		callback(TOPOLOGY_MODES, static_cast<uchar>(n), callbackData);
+	}
+}
+
+/* main thread */
+static void modes_awake_cb(void *data)
+{
+	finish(reinterpret_cast<display_t *>(data));
+}
+
+static unsigned __stdcall modes_thread(void *data)
+{
+	display_t *d = reinterpret_cast<display_t *>(data);
+
+	trace_begin("enumModes");
+	configuration::enumModes(device_name(d), d->modes);
+	trace_end("enumModes");
+
+	Fl::awake(modes_awake_cb, d);
+
+	return 0;
+}
+
+/* take the mode list of display `n' from the cache or start a worker */
+static void load_modes(display_t *d, uchar n)
+{
+	if (cache_get_reslist(n, d->modes)) {
+		d->ready = true;
+		return;
+	}
+
+	d->thread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, modes_thread, d, 0, NULL));
+
+	if (!d->thread) {
+		/* enumerate on this thread then */
+		configuration::enumModes(device_name(d), d->modes);
+		finish(d);
+	}
+}
+
+static void refresh(void);
+
+/* main thread; replaces the topology with a new scan, keeping the entries
+ * (and their mode lists) of all displays that didn't change */
+static void apply_cb(void *data)
+{
+	std::vector<display_t *> *list = reinterpret_cast<std::vector<display_t *> *>(data);
+	std::vector<display_t *> added;
+	bool changed = (list->size() != displays.size());
+
+	scanned = NULL;
+
+	for (size_t i = 0; i < list->size(); ++i) {
+		display_t *d = list->at(i);
+		display_t *keep = NULL;
+
+		for (size_t j = 0; j < displays.size(); ++j) {
+			if (displays.at(j)->name == d->name && displays.at(j)->id == d->id) {
+				keep = displays.at(j);
+				break;
+			}
+		}
+
+		if (!keep) {
+			added.push_back(d);
+			changed = true;
+			continue;
+		}
+
+		if (i >= displays.size() || displays.at(i) != keep || keep->label != d->label) {
+			changed = true;
+		}
+
+		/* only the desktop mode changes on WM_DISPLAYCHANGE */
+		keep->label = d->label;
+		keep->desktopMode = d->desktopMode;
+		list->at(i) = keep;
+		delete d;
+	}
+
+	for (size_t i = 0; i < displays.size(); ++i) {
+		if (std::find(list->begin(), list->end(), displays.at(i)) == list->end()) {
+			removed.push_back(displays.at(i));
+		}
+	}
+
+	displays = *list;
+	delete list;
+
+	if (changed) {
+		trace_instant("display topology changed");
+
+		/* the cached lists are stored by index */
+		cache_refresh_displays();
+
+		for (size_t i = 0; i < displays.size(); ++i) {
+			if (displays.at(i)->ready) {
+				cache_put_reslist(static_cast<uchar>(i), displays.at(i)->modes);
+			}
+		}
+
+		for (size_t i = 0; i < added.size(); ++i) {
+			load_modes(added.at(i), static_cast<uchar>(index_of(added.at(i))));
+		}
+
+		if (callback) {
+			callback(TOPOLOGY_CHANGED, 0, callbackData);
+		}
+	}
+
+	refreshRunning = false;
+
+	if (refreshThread) {
+		CloseHandle(refreshThread);
+		refreshThread = NULL;
+	}
+
+	if (refreshPending) {
+		refreshPending = false;
+		refresh();
+	}
+}
+
+static unsigned __stdcall refresh_thread(void *)
+{
+	trace_begin("topology scan");
+	scanned = scan();
+	trace_end("topology scan");
+
+	Fl::awake(apply_cb, scanned);
+
+	return 0;
+}
+
+/* main thread; enumerating the adapters can take a while on a docking
+ * station, so it's done in the background too */
+static void refresh(void)
+{
+	if (refreshRunning) {
+		refreshPending = true;
+		return;
+	}
+
+	refreshRunning = true;
+
+	refreshThread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, refresh_thread, NULL, 0, NULL));
+
+	if (!refreshThread) {
+		apply_cb(scan());
+	}
+}
+
+static void refresh_cb(void *)
+{
+	refresh();
+}
+
+static void topology_hook(UINT msg, WPARAM wParam, LPARAM)
+{
+	if (msg == WM_DISPLAYCHANGE || (msg == WM_DEVICECHANGE && wParam == DBT_DEVNODES_CHANGED)) {
+		/* wait until the burst of messages is over */
+		Fl::remove_timeout(refresh_cb);
+		Fl::add_timeout(REFRESH_DELAY, refresh_cb);
+	}
+}
+
+void topology_init(bool loadModes)
+{
+	if (!displays.empty()) {
+		return;
+	}
+
+	trace_begin("topology scan");
+	std::vector<display_t *> *list = scan();
+	trace_end("topology scan");
+
+	displays = *list;
+	delete list;
+
+	if (!loadModes) {
+		return;
+	}
+
+	Fl::lock();
+
+	for (size_t i = 0; i < displays.size(); ++i) {
+		load_modes(displays.at(i), static_cast<uchar>(i));
+	}
+}
+
+void topology_callback(topology_cb_t cb, void *data)
+{
+	callback = cb;
+	callbackData = data;
+}
+
+void topology_watch(HWND hwnd)
+{
+	window_hook_add(topology_hook);
+	window_hooks_attach(hwnd);
+}
+
+uchar topology_count(void)
+{
+	return displays.empty() ? 1 : static_cast<uchar>(displays.size());
+}
+
+const char *topology_name(uchar display)
+{
+	return (display < displays.size()) ? device_name(displays.at(display)) : NULL;
+}
+
+const char *topology_label(uchar display)
+{
+	return (display < displays.size()) ? displays.at(display)->label.c_str() : "";
+}
+
+uint32_t topology_desktop_mode(uchar display)
+{
+	return (display < displays.size()) ? displays.at(display)->desktopMode : 0;
+}
+
+const modeTable *topology_modes(uchar display)
+{
+	if (display >= displays.size() || !displays.at(display)->ready) {
+		return NULL;
+	}
+	return &displays.at(display)->modes;
+}
+
+const modeTable *topology_wait(uchar display)
+{
+	if (display >= displays.size()) {
+		return NULL;
+	}
+
+	display_t *d = displays.at(display);
+
+	if (d->ready) {
+		return &d->modes;
+	}
+
+	if (!d->thread) {
+		/* topology_init() was told not to load the modes */
+		if (cache_get_reslist(display, d->modes)) {
+			d->ready = true;
+		} else {
+			configuration::enumModes(device_name(d), d->modes);
+			finish(d);
+		}
+		return &d->modes;
+	}
+
+	trace_begin("topology_wait");
+	WaitForSingleObject(d->thread, INFINITE);
+	trace_end("topology_wait");
+
+	/* the Fl::awake() message is still queued, finish() ignores it then */
+	finish(d);
+
+	return &d->modes;
+}
+
+static void free_entry(display_t *d)
+{
+	if (d->thread) {
+		WaitForSingleObject(d->thread, INFINITE);
+		CloseHandle(d->thread);
+	}
+	delete d;
+}
+
+void topology_free(void)
+{
+	Fl::remove_timeout(refresh_cb);
+
+	/* a scan that apply_cb() didn't get to is freed here */
+	if (refreshThread) {
+		WaitForSingleObject(refreshThread, INFINITE);
+		CloseHandle(refreshThread);
+		refreshThread = NULL;
+	}
+
+	if (scanned) {
+		for (size_t i = 0; i < scanned->size(); ++i) {
+			delete scanned->at(i);
+		}
+		delete scanned;
+		scanned = NULL;
+	}
+
+	for (size_t i = 0; i < displays.size(); ++i) {
+		free_entry(displays.at(i));
+	}
+
+	for (size_t i = 0; i < removed.size(); ++i) {
+		free_entry(removed.at(i));
+	}
+
+	displays.clear();
+	removed.clear();
+	refreshRunning = refreshPending = false;
+}
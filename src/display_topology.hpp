@@ -0,0 +1,93 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Display topology: the attached display adapters, their monitors, the
+ * current desktop mode and the supported display modes.
+ *
+ * The adapters are enumerated once at startup; their mode lists are filled
+ * by one worker thread per display (or from the startup cache) and handed
+ * to the main thread with Fl::awake().
+ *
+ * After topology_watch() the launcher window reacts to WM_DISPLAYCHANGE and
+ * WM_DEVICECHANGE: the adapters are enumerated again on a worker thread and
+ * only displays that are new or have changed get their modes enumerated
+ * again, everything else is kept.
+ *
+ * Except for the worker threads everything here must be used from the main
+ * thread.
+ */
+
+#ifndef DISPLAY_TOPOLOGY_HPP
+#define DISPLAY_TOPOLOGY_HPP
+
+#include <stdint.h>
+
+#include "mode_table.hpp"
+#include "native_window.hpp"
+
+typedef unsigned char uchar;
+
+enum {
+	TOPOLOGY_MODES,    /* the mode list of `display' is available */
+	TOPOLOGY_CHANGED   /* displays were added, removed or replaced */
+};
+
+/* called on the main thread */
+typedef void (*topology_cb_t)(int event, uchar display, void *data);
+
+/* enumerate the display adapters and, if `loadModes' is set, start loading
+ * their mode lists in the background; calls Fl::lock() to enable Fl::awake() */
+void topology_init(bool loadModes);
+
+/* set the function that is called on topology events */
+void topology_callback(topology_cb_t cb, void *data);
+
+/* react to display changes sent to this window */
+void topology_watch(nativeWindow hwnd);
+
+/* number of displays (at least 1) */
+uchar topology_count(void);
+
+/* device name like "\\.\DISPLAY1", or NULL for the default display (if no
+ * adapter could be enumerated) */
+const char *topology_name(uchar display);
+
+/* menu label of a display */
+const char *topology_label(uchar display);
+
+/* current desktop mode as MODE_KEY(), 0 if unknown */
+uint32_t topology_desktop_mode(uchar display);
+
+/* the mode list of a display, or NULL if it's still loading */
+const modeTable *topology_modes(uchar display);
+
+/* block until the mode list of a display is available */
+const modeTable *topology_wait(uchar display);
+
+/* wait for the worker threads and free all displays and their mode lists;
+ * Fl::awake() messages that are still queued must not be handled after this */
+void topology_free(void);
+
+#endif  /* DISPLAY_TOPOLOGY_HPP */
@@ -0,0 +1,233 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* The X11 version of the display topology.  Every connected output with a
+ * CRTC is a display; the primary output comes first, which is the order in
+ * which Wine numbers them.  Asking XRandR for the modes is a single round
+ * trip, so everything is read in topology_init() and the mode lists are
+ * ready right away.  Without XRandR (Xvfb without the extension, nested X
+ * servers) the screen is the only display and its size the only mode. */
+
+#include <FL/Fl.H>
+#include <FL/x.H>
+#include <X11/Xlib.h>
+#include <X11/extensions/Xrandr.h>
+
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+#include "display_topology.hpp"
+#include "trace.hpp"
+
+
+typedef struct {
+	std::string name;  /* output name like "HDMI-1", empty for the screen */
+	std::string label;
+	uint32_t desktopMode;
+	modeTable modes;
+} display_t;
+
+static std::vector<display_t *> displays;
+
+static topology_cb_t callback = NULL;
+static void *callbackData = NULL;
+
+
+/* the modes of an output; the ones XRandR lists for it are looked up in the
+ * mode table of the screen, ids that aren't in there are left out */
+class randrModes : public modeSource
+{
+private:
+	std::vector<const XRRModeInfo *> _modes;
+
+public:
+	randrModes(const XRRScreenResources *res, const XRROutputInfo *output)
+	{
+		for (int i = 0; i < output->nmode; ++i) {
+			for (int j = 0; j < res->nmode; ++j) {
+				if (res->modes[j].id == output->modes[i]) {
+					if (res->modes[j].width > 0 && res->modes[j].height > 0) {
+						_modes.push_back(&res->modes[j]);
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	bool mode(int i, uint16_t &w, uint16_t &h) {
+		if (i >= static_cast<int>(_modes.size())) {
+			return false;
+		}
+
+		w = static_cast<uint16_t>(_modes.at(i)->width);
+		h = static_cast<uint16_t>(_modes.at(i)->height);
+		return true;
+	}
+};
+
+static void add_display(const char *name, uint32_t desktopMode)
+{
+	display_t *d = new display_t();
+	char buf[256];
+
+	if (name) {
+		snprintf(buf, sizeof(buf), "Display %d (%s)", static_cast<int>(displays.size()), name);
+		d->name = name;
+	} else {
+		snprintf(buf, sizeof(buf), "Display %d", static_cast<int>(displays.size()));
+	}
+
+	d->label = buf;
+	d->desktopMode = desktopMode;
+	displays.push_back(d);
+}
+
+static void add_output(XRRScreenResources *res, RROutput id)
+{
+	XRROutputInfo *output = XRRGetOutputInfo(fl_display, res, id);
+
+	if (!output) {
+		return;
+	}
+
+	if (output->connection == RR_Connected && output->crtc != 0 && output->nmode > 0) {
+		XRRCrtcInfo *crtc = XRRGetCrtcInfo(fl_display, res, output->crtc);
+		randrModes src(res, output);
+
+		/* the size of the CRTC is already rotated */
+		add_display(output->name, crtc ? MODE_KEY(crtc->width, crtc->height) : 0);
+		displays.back()->modes.fill(src);
+
+		if (crtc) {
+			XRRFreeCrtcInfo(crtc);
+		}
+	}
+
+	XRRFreeOutputInfo(output);
+}
+
+static void scan(void)
+{
+	Window root = RootWindow(fl_display, fl_screen);
+	int event, error;
+
+	if (XRRQueryExtension(fl_display, &event, &error)) {
+		XRRScreenResources *res = XRRGetScreenResourcesCurrent(fl_display, root);
+
+		if (res) {
+			RROutput primary = XRRGetOutputPrimary(fl_display, root);
+
+			if (primary != 0) {
+				add_output(res, primary);
+			}
+
+			for (int i = 0; i < res->noutput && displays.size() < 0xFF; ++i) {
+				if (res->outputs[i] != primary) {
+					add_output(res, res->outputs[i]);
+				}
+			}
+
+			XRRFreeScreenResources(res);
+		}
+	}
+
+	if (displays.empty()) {
+		uint16_t w = static_cast<uint16_t>(DisplayWidth(fl_display, fl_screen));
+		uint16_t h = static_cast<uint16_t>(DisplayHeight(fl_display, fl_screen));
+
+		add_display(NULL, MODE_KEY(w, h));
+		displays.back()->modes.add(w, h);
+	}
+}
+
+void topology_init(bool loadModes)
+{
+	if (!displays.empty()) {
+		return;
+	}
+
+	fl_open_display();
+
+	trace_begin("topology scan");
+	scan();
+	trace_end("topology scan");
+
+	if (loadModes) {
+		Fl::lock();
+	}
+}
+
+void topology_free(void)
+{
+	for (size_t i = 0; i < displays.size(); ++i) {
+		delete displays.at(i);
+	}
+	displays.clear();
+}
+
+void topology_callback(topology_cb_t cb, void *data)
+{
+	callback = cb;
+	callbackData = data;
+}
+
+/* FLTK 1.3 doesn't pass on RandR events, so the displays are read once */
+void topology_watch(nativeWindow)
+{
+}
+
+uchar topology_count(void)
+{
+	return displays.empty() ? 1 : static_cast<uchar>(displays.size());
+}
+
+const char *topology_name(uchar display)
+{
+	if (display >= displays.size() || displays.at(display)->name.empty()) {
+		return NULL;
+	}
+	return displays.at(display)->name.c_str();
+}
+
+const char *topology_label(uchar display)
+{
+	return (display < displays.size()) ? displays.at(display)->label.c_str() : "";
+}
+
+uint32_t topology_desktop_mode(uchar display)
+{
+	return (display < displays.size()) ? displays.at(display)->desktopMode : 0;
+}
+
+const modeTable *topology_modes(uchar display)
+{
+	return (display < displays.size()) ? &displays.at(display)->modes : NULL;
+}
+
+const modeTable *topology_wait(uchar display)
+{
+	return topology_modes(display);
+}
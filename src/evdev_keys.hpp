@@ -0,0 +1,206 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Linux input event key codes (KEY_* in linux/input-event-codes.h) and their
+ * DirectInput counterparts.
+ *
+ * The codes below 89 are the PC scan codes and are the same in both.  The
+ * extended keys have bit 7 set in DirectInput.  An X11 key code is the evdev
+ * code plus 8.  Keys that DirectInput doesn't know are 0.
+ */
+
+#ifndef EVDEV_KEYS_HPP
+#define EVDEV_KEYS_HPP
+
+typedef unsigned char uchar;
+
+#define EVDEV_X11_OFFSET  8
+
+/* the DirectInput key codes used outside of Windows, as in dinput.h */
+#ifndef _WIN32
+#define DIK_ESCAPE        0x01
+#define DIK_BACK          0x0E
+#define DIK_TAB           0x0F
+#define DIK_RETURN        0x1C
+#define DIK_LCONTROL      0x1D
+#define DIK_APOSTROPHE    0x28
+#define DIK_GRAVE         0x29
+#define DIK_LSHIFT        0x2A
+#define DIK_RSHIFT        0x36
+#define DIK_MULTIPLY      0x37
+#define DIK_LMENU         0x38
+#define DIK_SPACE         0x39
+#define DIK_F1            0x3B
+#define DIK_F2            0x3C
+#define DIK_F3            0x3D
+#define DIK_F4            0x3E
+#define DIK_F5            0x3F
+#define DIK_F6            0x40
+#define DIK_F7            0x41
+#define DIK_F8            0x42
+#define DIK_F9            0x43
+#define DIK_F10           0x44
+#define DIK_NUMPAD7       0x47
+#define DIK_NUMPAD8       0x48
+#define DIK_NUMPAD9       0x49
+#define DIK_SUBTRACT      0x4A
+#define DIK_NUMPAD4       0x4B
+#define DIK_NUMPAD5       0x4C
+#define DIK_NUMPAD6       0x4D
+#define DIK_ADD           0x4E
+#define DIK_NUMPAD1       0x4F
+#define DIK_NUMPAD2       0x50
+#define DIK_NUMPAD3       0x51
+#define DIK_NUMPAD0       0x52
+#define DIK_DECIMAL       0x53
+#define DIK_OEM_102       0x56
+#define DIK_F11           0x57
+#define DIK_F12           0x58
+#define DIK_F13           0x64
+#define DIK_F14           0x65
+#define DIK_F15           0x66
+#define DIK_KANA          0x70
+#define DIK_ABNT_C1       0x73
+#define DIK_CONVERT       0x79
+#define DIK_NOCONVERT     0x7B
+#define DIK_YEN           0x7D
+#define DIK_ABNT_C2       0x7E
+#define DIK_NUMPADEQUALS  0x8D
+#define DIK_PREVTRACK     0x90
+#define DIK_AT            0x91
+#define DIK_COLON         0x92
+#define DIK_UNDERLINE     0x93
+#define DIK_AX            0x96
+#define DIK_UNLABELED     0x97
+#define DIK_NEXTTRACK     0x99
+#define DIK_NUMPADENTER   0x9C
+#define DIK_RCONTROL      0x9D
+#define DIK_MUTE          0xA0
+#define DIK_CALCULATOR    0xA1
+#define DIK_PLAYPAUSE     0xA2
+#define DIK_MEDIASTOP     0xA4
+#define DIK_VOLUMEDOWN    0xAE
+#define DIK_VOLUMEUP      0xB0
+#define DIK_WEBHOME       0xB2
+#define DIK_NUMPADCOMMA   0xB3
+#define DIK_DIVIDE        0xB5
+#define DIK_SYSRQ         0xB7
+#define DIK_RMENU         0xB8
+#define DIK_PAUSE         0xC5
+#define DIK_HOME          0xC7
+#define DIK_UP            0xC8
+#define DIK_PRIOR         0xC9
+#define DIK_LEFT          0xCB
+#define DIK_RIGHT         0xCD
+#define DIK_END           0xCF
+#define DIK_DOWN          0xD0
+#define DIK_NEXT          0xD1
+#define DIK_INSERT        0xD2
+#define DIK_DELETE        0xD3
+#define DIK_LWIN          0xDB
+#define DIK_RWIN          0xDC
+#define DIK_APPS          0xDD
+#define DIK_POWER         0xDE
+#define DIK_SLEEP         0xDF
+#define DIK_WAKE          0xE3
+#define DIK_WEBFORWARD    0xE9
+#define DIK_WEBBACK       0xEA
+#define DIK_MAIL          0xEC
+#endif
+
+
+constexpr uchar evdev_to_dik(unsigned int code)
+{
+	if ((code >= 1 && code <= 83) || (code >= 86 && code <= 88)) {
+		return static_cast<uchar>(code);
+	}
+
+	switch (code) {
+	case 89:  return DIK_ABNT_C1;  /* KEY_RO */
+	case 92:  return DIK_CONVERT;  /* KEY_HENKAN */
+	case 93:  return DIK_KANA;  /* KEY_KATAKANAHIRAGANA */
+	case 94:  return DIK_NOCONVERT;  /* KEY_MUHENKAN */
+	case 96:  return DIK_NUMPADENTER;  /* KEY_KPENTER */
+	case 97:  return DIK_RCONTROL;  /* KEY_RIGHTCTRL */
+	case 98:  return DIK_DIVIDE;  /* KEY_KPSLASH */
+	case 99:  return DIK_SYSRQ;  /* KEY_SYSRQ */
+	case 100: return DIK_RMENU;  /* KEY_RIGHTALT */
+	case 102: return DIK_HOME;  /* KEY_HOME */
+	case 103: return DIK_UP;  /* KEY_UP */
+	case 104: return DIK_PRIOR;  /* KEY_PAGEUP */
+	case 105: return DIK_LEFT;  /* KEY_LEFT */
+	case 106: return DIK_RIGHT;  /* KEY_RIGHT */
+	case 107: return DIK_END;  /* KEY_END */
+	case 108: return DIK_DOWN;  /* KEY_DOWN */
+	case 109: return DIK_NEXT;  /* KEY_PAGEDOWN */
+	case 110: return DIK_INSERT;  /* KEY_INSERT */
+	case 111: return DIK_DELETE;  /* KEY_DELETE */
+	case 113: return DIK_MUTE;  /* KEY_MUTE */
+	case 114: return DIK_VOLUMEDOWN;  /* KEY_VOLUMEDOWN */
+	case 115: return DIK_VOLUMEUP;  /* KEY_VOLUMEUP */
+	case 116: return DIK_POWER;  /* KEY_POWER */
+	case 117: return DIK_NUMPADEQUALS;  /* KEY_KPEQUAL */
+	case 119: return DIK_PAUSE;  /* KEY_PAUSE */
+	case 121: return DIK_NUMPADCOMMA;  /* KEY_KPCOMMA */
+	case 124: return DIK_YEN;  /* KEY_YEN */
+	case 125: return DIK_LWIN;  /* KEY_LEFTMETA */
+	case 126: return DIK_RWIN;  /* KEY_RIGHTMETA */
+	case 127: return DIK_APPS;  /* KEY_COMPOSE */
+	case 140: return DIK_CALCULATOR;  /* KEY_CALC */
+	case 142: return DIK_SLEEP;  /* KEY_SLEEP */
+	case 143: return DIK_WAKE;  /* KEY_WAKEUP */
+	case 155: return DIK_MAIL;  /* KEY_MAIL */
+	case 158: return DIK_WEBBACK;  /* KEY_BACK */
+	case 159: return DIK_WEBFORWARD;  /* KEY_FORWARD */
+	case 163: return DIK_NEXTTRACK;  /* KEY_NEXTSONG */
+	case 164: return DIK_PLAYPAUSE;  /* KEY_PLAYPAUSE */
+	case 165: return DIK_PREVTRACK;  /* KEY_PREVIOUSSONG */
+	case 166: return DIK_MEDIASTOP;  /* KEY_STOPCD */
+	case 172: return DIK_WEBHOME;  /* KEY_HOMEPAGE */
+	case 183: return DIK_F13;  /* KEY_F13 */
+	case 184: return DIK_F14;  /* KEY_F14 */
+	case 185: return DIK_F15;  /* KEY_F15 */
+	}
+
+	return 0;
+}
+
+/* evdev code of a DirectInput key, 0 if there is none */
+constexpr unsigned int dik_to_evdev(uchar dx)
+{
+	for (unsigned int code = 1; dx != 0 && code < 256; ++code) {
+		if (evdev_to_dik(code) == dx) {
+			return code;
+		}
+	}
+	return 0;
+}
+
+static_assert(evdev_to_dik(28) == DIK_RETURN && evdev_to_dik(57) == DIK_SPACE && evdev_to_dik(103) == DIK_UP,
+	"Enter, Space and Up must map to DIK_RETURN, DIK_SPACE and DIK_UP");
+static_assert(dik_to_evdev(DIK_LEFT) == 105 && dik_to_evdev(0x1E) == 30 && dik_to_evdev(0) == 0,
+	"DIK_LEFT and DIK_A must map back to KEY_LEFT and KEY_A");
+
+#endif  /* EVDEV_KEYS_HPP */
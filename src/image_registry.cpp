@@ -0,0 +1,380 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <FL/Fl.H>
+#include <FL/Fl_Image.H>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "assetpack.h"
+#include "image_registry.hpp"
+#include "trace.hpp"
+
+
+#define IMAGE(x)  { #x, "decode " #x }
+static LazyImage images[IMG_COUNT] = {
+	IMAGE(arrow_01),
+	IMAGE(arrow_02),
+	IMAGE(arrow_03),
+	IMAGE(arrow_04),
+	IMAGE(back1),
+	IMAGE(back2),
+	IMAGE(back3),
+	IMAGE(button_01),
+	IMAGE(button_02),
+	IMAGE(button_03),
+	IMAGE(button_04),
+	IMAGE(button_05),
+	IMAGE(pad_controls_v02)
+};
+#undef IMAGE
+
+#ifdef _WIN32
+static HANDLE predecodeThread = NULL;
+static volatile LONG predecodeCancel = 0;
+#else
+static pthread_t predecodeThread;
+static bool predecodeRunning = false;
+static volatile int predecodeCancel = 0;
+#endif
+static image_id predecodeIds[IMG_COUNT];
+static int predecodeCount = 0;
+
+
+#ifdef _WIN32
+
+/* Every image is a single-entry asset pack compiled by assetc and stored as
+ * an RCDATA resource named like the image (see SonicLauncher.rc).
+ * LockResource() returns a pointer into the mapped executable, so nothing is
+ * copied and the pages are only faulted in once an image is decoded. */
+static const uchar *find_asset(const char *name, size_t *len)
+{
+	HRSRC res;
+	HGLOBAL mem;
+
+	*len = 0;
+
+	if ((res = FindResourceA(NULL, name, MAKEINTRESOURCEA(10) /* RT_RCDATA */)) == NULL ||
+		(mem = LoadResource(NULL, res)) == NULL)
+	{
+		return NULL;
+	}
+
+	*len = SizeofResource(NULL, res);
+	return reinterpret_cast<const uchar *>(LockResource(mem));
+}
+
+#else
+
+/* The same packs are linked in by SonicLauncher.S, which brackets each one
+ * with a start and an end symbol.  They are in the read-only data of the
+ * executable, so like on Windows nothing is copied. */
+#define ASSET(x)  extern "C" const uchar asset_##x[], asset_##x##_end[];
+ASSET(arrow_01) ASSET(arrow_02) ASSET(arrow_03) ASSET(arrow_04)
+ASSET(back1) ASSET(back2) ASSET(back3)
+ASSET(button_01) ASSET(button_02) ASSET(button_03) ASSET(button_04) ASSET(button_05)
+ASSET(pad_controls_v02)
+#undef ASSET
+
+static const uchar *find_asset(const char *name, size_t *len)
+{
+#define ASSET(x)  { #x, asset_##x, asset_##x##_end }
+	static const struct { const char *name; const uchar *start, *end; } assets[] = {
+		ASSET(arrow_01), ASSET(arrow_02), ASSET(arrow_03), ASSET(arrow_04),
+		ASSET(back1), ASSET(back2), ASSET(back3),
+		ASSET(button_01), ASSET(button_02), ASSET(button_03), ASSET(button_04), ASSET(button_05),
+		ASSET(pad_controls_v02)
+	};
+#undef ASSET
+
+	for (size_t i = 0; i < sizeof(assets) / sizeof(*assets); ++i) {
+		if (strcmp(assets[i].name, name) == 0) {
+			*len = static_cast<size_t>(assets[i].end - assets[i].start);
+			return assets[i].start;
+		}
+	}
+
+	*len = 0;
+	return NULL;
+}
+
+#endif  /* _WIN32 */
+
+
+LazyImage::LazyImage(const char *name, const char *traceName)
+	: Fl_Image(0, 0, 4)
+{
+	_name = name;
+	_traceName = traceName;
+#ifdef _WIN32
+	InitializeCriticalSection(&_lock);
+#else
+	pthread_mutex_init(&_lock, NULL);
+#endif
+}
+
+LazyImage::~LazyImage()
+{
+	if (_img) {
+		delete _img;
+	}
+#ifdef _WIN32
+	DeleteCriticalSection(&_lock);
+#else
+	pthread_mutex_destroy(&_lock);
+#endif
+}
+
+void LazyImage::bind()
+{
+	if (_bound) {
+		return;
+	}
+
+	_pack = find_asset(_name, &_packLen);
+	_valid = (_pack && assetpack_find(_pack, _packLen, _name, &_entry) != 0);
+
+	if (_valid) {
+		w(_entry.w);
+		h(_entry.h);
+		d(_entry.d);
+	}
+
+	_bound = true;
+}
+
+/* _img is read without the lock, so it's published with release semantics
+ * and read with acquire semantics; the pixels are complete once the pointer
+ * is seen */
+static Fl_Image *load_acquire(Fl_Image **p)
+{
+#ifdef _WIN32
+	PVOID volatile *v = reinterpret_cast<PVOID volatile *>(p);
+	return reinterpret_cast<Fl_Image *>(InterlockedCompareExchangePointer(v, NULL, NULL));
+#else
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static void store_release(Fl_Image **p, Fl_Image *img)
+{
+#ifdef _WIN32
+	InterlockedExchangePointer(reinterpret_cast<PVOID volatile *>(p), img);
+#else
+	__atomic_store_n(p, img, __ATOMIC_RELEASE);
+#endif
+}
+
+Fl_Image *LazyImage::decode()
+{
+	Fl_Image *img = load_acquire(&_img);
+
+	/* fast path once the image is available */
+	if (img) {
+		return img;
+	}
+
+#ifdef _WIN32
+	EnterCriticalSection(&_lock);
+#else
+	pthread_mutex_lock(&_lock);
+#endif
+
+	if (!_img) {
+		trace_begin(_traceName);
+
+		size_t len = static_cast<size_t>(w()) * h() * d();
+		uchar *pixels = new uchar[len > 0 ? len : 1];
+
+		if (!_valid || !assetpack_decode(_pack, _packLen, &_entry, pixels)) {
+			/* draw nothing rather than garbage */
+			memset(pixels, 0, len);
+		}
+
+		Fl_RGB_Image *rgb = new Fl_RGB_Image(pixels, w(), h(), d());
+		rgb->alloc_array = 1;
+
+		trace_end(_traceName);
+
+		store_release(&_img, rgb);
+	}
+
+	img = _img;
+
+#ifdef _WIN32
+	LeaveCriticalSection(&_lock);
+#else
+	pthread_mutex_unlock(&_lock);
+#endif
+
+	return img;
+}
+
+bool LazyImage::decoded()
+{
+	return load_acquire(&_img) != NULL;
+}
+
+Fl_Image *LazyImage::copy(int W, int H)
+{
+	return decode()->copy(W, H);
+}
+
+void LazyImage::color_average(Fl_Color c, float i)
+{
+	decode()->color_average(c, i);
+}
+
+void LazyImage::desaturate()
+{
+	decode()->desaturate();
+}
+
+void LazyImage::draw(int X, int Y, int W, int H, int cx, int cy)
+{
+	decode()->draw(X, Y, W, H, cx, cy);
+}
+
+void LazyImage::uncache()
+{
+	Fl_Image *img = load_acquire(&_img);
+
+	if (img) {
+		img->uncache();
+	}
+}
+
+void LazyImage::release()
+{
+#ifdef _WIN32
+	EnterCriticalSection(&_lock);
+#else
+	pthread_mutex_lock(&_lock);
+#endif
+
+	if (_img) {
+		delete _img;
+		store_release(&_img, NULL);
+	}
+
+#ifdef _WIN32
+	LeaveCriticalSection(&_lock);
+#else
+	pthread_mutex_unlock(&_lock);
+#endif
+}
+
+LazyImage *get_image(image_id id)
+{
+	images[id].bind();
+	return &images[id];
+}
+
+#ifdef _WIN32
+static unsigned __stdcall predecode_thread(void *)
+#else
+static void *predecode_thread(void *)
+#endif
+{
+	for (int i = 0; i < predecodeCount && predecodeCancel == 0; ++i) {
+		images[predecodeIds[i]].decode();
+	}
+	return 0;
+}
+
+void image_predecode(const image_id *ids, int count)
+{
+#ifdef _WIN32
+	if (predecodeThread) {
+#else
+	if (predecodeRunning) {
+#endif
+		/* only one batch at a time; the images are decoded on draw anyway */
+		return;
+	}
+
+	if (count > IMG_COUNT) {
+		count = IMG_COUNT;
+	}
+
+	for (int i = 0; i < count; ++i) {
+		predecodeIds[i] = ids[i];
+		images[ids[i]].bind();
+	}
+	predecodeCount = count;
+	predecodeCancel = 0;
+
+#ifdef _WIN32
+	predecodeThread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, predecode_thread, NULL, CREATE_SUSPENDED, NULL));
+
+	if (predecodeThread) {
+		SetThreadPriority(predecodeThread, THREAD_PRIORITY_BELOW_NORMAL);
+		ResumeThread(predecodeThread);
+	}
+#else
+	/* the thread inherits the priority; the first paint only needs the
+	 * images of the "Settings" tab, which are decoded on the main thread */
+	predecodeRunning = (pthread_create(&predecodeThread, NULL, predecode_thread, NULL) == 0);
+#endif
+}
+
+void image_predecode_cancel(void)
+{
+#ifdef _WIN32
+	if (!predecodeThread) {
+		return;
+	}
+
+	/* an image that is already being decoded will be finished */
+	InterlockedExchange(&predecodeCancel, 1);
+	WaitForSingleObject(predecodeThread, INFINITE);
+	CloseHandle(predecodeThread);
+	predecodeThread = NULL;
+#else
+	if (!predecodeRunning) {
+		return;
+	}
+
+	__sync_lock_test_and_set(&predecodeCancel, 1);
+	pthread_join(predecodeThread, NULL);
+	predecodeRunning = false;
+#endif
+}
+
+void image_release_all(void)
+{
+	image_predecode_cancel();
+
+	for (int i = 0; i < IMG_COUNT; ++i) {
+		images[i].release();
+	}
+}
@@ -0,0 +1,112 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef IMAGE_REGISTRY_HPP
+#define IMAGE_REGISTRY_HPP
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <FL/Fl.H>
+#include <FL/Fl_Image.H>
+
+#include "assetpack.h"
+
+enum image_id {
+	IMG_ARROW_01,
+	IMG_ARROW_02,
+	IMG_ARROW_03,
+	IMG_ARROW_04,
+	IMG_BACK1,
+	IMG_BACK2,
+	IMG_BACK3,
+	IMG_BUTTON_01,
+	IMG_BUTTON_02,
+	IMG_BUTTON_03,
+	IMG_BUTTON_04,
+	IMG_BUTTON_05,
+	IMG_PAD_CONTROLS_V02,
+	IMG_COUNT
+};
+
+
+/* An image from an embedded asset pack that is only decoded when it's drawn
+ * the first time (or when a background thread gets to it first).  Width and
+ * height are taken from the pack index, so widgets can be laid out without
+ * decoding anything.  The resource itself isn't looked up before the image is
+ * requested with get_image(), so code paths without a GUI never touch it. */
+class LazyImage : public Fl_Image
+{
+private:
+	const char *_name;
+	const char *_traceName;
+	const uchar *_pack = NULL;
+	size_t _packLen = 0;
+	assetpack_entry_t _entry;
+	bool _bound = false;
+	bool _valid = false;
+	Fl_Image *_img = NULL;
+#ifdef _WIN32
+	CRITICAL_SECTION _lock;
+#else
+	pthread_mutex_t _lock;
+#endif
+
+public:
+	LazyImage(const char *name, const char *traceName);
+	~LazyImage();
+
+	/* look up the resource and set the image size; called by get_image() */
+	void bind();
+
+	/* decode the image if that hasn't happened yet; thread-safe */
+	Fl_Image *decode();
+	bool decoded();
+
+	/* free the decoded image; it's decoded again when it's drawn */
+	void release();
+
+	Fl_Image *copy(int W, int H);
+	void color_average(Fl_Color c, float i);
+	void desaturate();
+	void draw(int X, int Y, int W, int H, int cx = 0, int cy = 0);
+	void uncache();
+};
+
+/* must be called from the main thread */
+LazyImage *get_image(image_id id);
+
+/* decode the given images on a low priority background thread */
+void image_predecode(const image_id *ids, int count);
+
+/* stop the background thread (if any) and wait for it */
+void image_predecode_cancel(void);
+
+/* stop the background thread and free every decoded image */
+void image_release_all(void);
+
+#endif  /* IMAGE_REGISTRY_HPP */
@@ -0,0 +1,69 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "key_bindings.hpp"
+
+
+bool keyBindings::assign(const uchar *keys, int count)
+{
+	bool unique = true;
+
+	clear();
+
+	for (int i = 0; i < count; ++i) {
+		if (!add(keys[i], i)) {
+			unique = false;
+		}
+	}
+
+	return unique;
+}
+
+int keyBindings::rebind(uchar *keys, int slot, uchar dx, bool swap)
+{
+	uchar old = keys[slot];
+	int other = owner(dx);
+
+	if (other == slot) {
+		return other;
+	}
+
+	if (other != -1) {
+		if (!swap) {
+			return other;
+		}
+
+		/* the other slot takes over the old key */
+		keys[other] = old;
+		_owner[old] = static_cast<uchar>(other);
+		_owner[dx] = static_cast<uchar>(slot);
+		keys[slot] = dx;
+		return other;
+	}
+
+	remove(old);
+	add(dx, slot);
+	keys[slot] = dx;
+	return -1;
+}
@@ -0,0 +1,87 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Owner table of the bound keys.
+ *
+ * A 256 bit set tells which key codes are bound and a table next to it which
+ * key slot (the index into confData::keys) owns them.  The table is only read
+ * for keys that are in the set, so it never needs to be cleared and clearing
+ * everything costs 32 bytes.  Finding the owner of a key is O(1) and nothing
+ * is allocated.
+ */
+
+#ifndef KEY_BINDINGS_HPP
+#define KEY_BINDINGS_HPP
+
+#include <stdint.h>
+#include <string.h>
+
+typedef unsigned char uchar;
+
+
+class keyBindings
+{
+private:
+	uint32_t _bound[256 / 32];
+	uchar _owner[256];
+
+public:
+	keyBindings() { clear(); }
+
+	void clear() { memset(_bound, 0, sizeof(_bound)); }
+
+	bool bound(uchar dx) const {
+		return (_bound[dx / 32] & (1u << (dx % 32))) != 0;
+	}
+
+	/* slot that owns the key or -1 */
+	int owner(uchar dx) const {
+		return bound(dx) ? _owner[dx] : -1;
+	}
+
+	/* returns false if another slot already owns the key */
+	bool add(uchar dx, int slot) {
+		if (bound(dx)) {
+			return false;
+		}
+		_bound[dx / 32] |= 1u << (dx % 32);
+		_owner[dx] = static_cast<uchar>(slot);
+		return true;
+	}
+
+	void remove(uchar dx) {
+		_bound[dx / 32] &= ~(1u << (dx % 32));
+	}
+
+	/* rebuild from `count' keys; returns false if a key is bound twice */
+	bool assign(const uchar *keys, int count);
+
+	/* move the key of `slot' in `keys' to `dx'; if another slot has `dx',
+	 * it gets the old key of `slot' if `swap' is set, otherwise nothing is
+	 * changed.  Returns the slot that had `dx' (-1 if none). */
+	int rebind(uchar *keys, int slot, uchar dx, bool swap);
+};
+
+#endif  /* KEY_BINDINGS_HPP */
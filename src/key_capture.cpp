@@ -0,0 +1,352 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <windows.h>
+#include <process.h>
+#include <string.h>
+
+#ifndef DIRECTINPUT_VERSION
+#define DIRECTINPUT_VERSION 0x0800
+#endif
+#include <dinput.h>
+
+#include <FL/Fl.H>
+
+#include "configuration.hpp"
+#include "key_capture.hpp"
+#include "key_state.hpp"
+#include "trace.hpp"
+#include "window_hooks.hpp"
+
+// https://blogs.msdn.microsoft.com/oldnewthing/20041025-00/?p=37483
+// https://stackoverflow.com/a/557859
+EXTERN_C IMAGE_DOS_HEADER __ImageBase;
+#define HINST_THISCOMPONENT  reinterpret_cast<HINSTANCE>(&__ImageBase)
+
+/* number of key events DirectInput keeps between two reads */
+#define BUFFER_SIZE  32
+
+
+static IDirectInput8 *directInput = NULL;
+static IDirectInputDevice8 *keyboard = NULL;
+
+static HANDLE keyEvent = NULL;   /* set by DirectInput */
+static HANDLE quitEvent = NULL;
+static HANDLE thread = NULL;
+static volatile LONG queued = 0;  /* a read_cb() message is pending */
+
+static key_capture_cb_t callback = NULL;
+static void *callbackData = NULL;
+static bool armed = false;
+
+static keyState keys;
+static DWORD pressTime[256];  /* GetTickCount() time stamps */
+
+/* when the capture was started, for the CPU usage counter */
+static LARGE_INTEGER armedTime;
+static ULONGLONG armedCpu = 0;
+
+
+static ULONGLONG process_cpu_time(void)
+{
+	FILETIME creation, exit, kernel, user;
+	ULARGE_INTEGER k, u;
+
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+		return 0;
+	}
+
+	k.LowPart = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+
+	return k.QuadPart + u.QuadPart;  /* 100ns units */
+}
+
+static void record_counters(DWORD timeStamp)
+{
+	LARGE_INTEGER freq, now;
+
+	/* the DirectInput time stamp uses GetTickCount() */
+	trace_counter("key capture latency ms", static_cast<long long>(GetTickCount() - timeStamp));
+
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+
+	double wall = static_cast<double>(now.QuadPart - armedTime.QuadPart) / freq.QuadPart;
+	double cpu = static_cast<double>(process_cpu_time() - armedCpu) / 1e7;
+
+	if (wall > 0) {
+		trace_counter("key capture CPU per mille", static_cast<long long>(cpu / wall * 1000.0));
+	}
+}
+
+static bool acquire(void)
+{
+	/* fails while another window is in the foreground */
+	return keyboard && armed && SUCCEEDED(keyboard->Acquire());
+}
+
+/* compare the keyboard with the tracked state; finds key presses that
+ * happened while no events were buffered */
+static void snapshot(void)
+{
+	uchar state[256];
+	size_t n = keys.pressed_count();
+
+	if (keyboard->GetDeviceState(sizeof(state), state) != DI_OK) {
+		return;
+	}
+
+	keys.update(state);
+
+	for ( ; n < keys.pressed_count(); ++n) {
+		pressTime[keys.pressed_key(n)] = GetTickCount();
+	}
+}
+
+/* main thread; reads everything DirectInput buffered since the last call */
+static void read_cb(void *)
+{
+	DIDEVICEOBJECTDATA data[BUFFER_SIZE];
+	DWORD n = BUFFER_SIZE;
+
+	/* a key press that arrives while reading queues another call */
+	InterlockedExchange(&queued, 0);
+
+	if (!keyboard || !armed) {
+		return;
+	}
+
+	keys.clear_edges();
+
+	while (n == BUFFER_SIZE) {
+		n = BUFFER_SIZE;
+		HRESULT res = keyboard->GetDeviceData(sizeof(*data), data, &n, 0);
+
+		if (res == DIERR_INPUTLOST || res == DIERR_NOTACQUIRED) {
+			if (acquire()) {
+				snapshot();
+			}
+			break;
+		}
+
+		if (FAILED(res)) {
+			break;
+		}
+
+		for (DWORD i = 0; i < n; ++i) {
+			uchar dx = static_cast<uchar>(data[i].dwOfs);
+			bool down = (data[i].dwData & 0x80) != 0;
+
+			if (down) {
+				pressTime[dx] = data[i].dwTimeStamp;
+			}
+			keys.key(dx, down);
+		}
+
+		if (res == DI_BUFFEROVERFLOW) {
+			/* older events were dropped */
+			snapshot();
+		}
+	}
+
+	/* the first key that went down wins, even if several are held */
+	for (size_t i = 0; i < keys.pressed_count(); ++i) {
+		uchar dx = keys.pressed_key(i);
+
+		/* don't ignore escape */
+		if (dx != DIK_ESCAPE && configuration::isIgnoredKey(dx)) {
+			continue;
+		}
+
+		record_counters(pressTime[dx]);
+		key_capture_stop();
+
+		if (callback) {
+			callback(dx, callbackData);
+		}
+		return;
+	}
+}
+
+static unsigned __stdcall capture_thread(void *)
+{
+	HANDLE events[2] = { keyEvent, quitEvent };
+
+	while (WaitForMultipleObjects(2, events, FALSE, INFINITE) == WAIT_OBJECT_0) {
+		/* one message is enough, read_cb() empties the whole buffer */
+		if (InterlockedExchange(&queued, 1) == 0) {
+			Fl::awake(read_cb, NULL);
+		}
+	}
+
+	return 0;
+}
+
+static void acquire_cb(void *)
+{
+	acquire();
+}
+
+static void capture_hook(UINT msg, WPARAM wParam, LPARAM)
+{
+	if (msg == WM_ACTIVATE && LOWORD(wParam) != WA_INACTIVE) {
+		/* the window isn't in the foreground yet while this is handled */
+		Fl::add_timeout(0.0, acquire_cb);
+	}
+}
+
+bool key_capture_init(void)
+{
+	DIPROPDWORD prop;
+
+	if (directInput) {
+		return true;
+	}
+
+	if (DirectInput8Create(HINST_THISCOMPONENT, DIRECTINPUT_VERSION, IID_IDirectInput8, reinterpret_cast<LPVOID *>(&directInput), NULL) != DI_OK) {
+		directInput = NULL;
+		return false;
+	}
+
+	if (directInput->CreateDevice(GUID_SysKeyboard, &keyboard, NULL) != DI_OK) {
+		keyboard = NULL;
+		key_capture_free();
+		return false;
+	}
+
+	memset(&prop, 0, sizeof(prop));
+	prop.diph.dwSize = sizeof(prop);
+	prop.diph.dwHeaderSize = sizeof(prop.diph);
+	prop.diph.dwHow = DIPH_DEVICE;
+	prop.dwData = BUFFER_SIZE;
+
+	keyEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+	quitEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+	if (keyboard->SetDataFormat(&c_dfDIKeyboard) != DI_OK ||
+		keyboard->SetProperty(DIPROP_BUFFERSIZE, &prop.diph) != DI_OK ||
+		!keyEvent || !quitEvent ||
+		keyboard->SetEventNotification(keyEvent) != DI_OK)
+	{
+		key_capture_free();
+		return false;
+	}
+
+	thread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, capture_thread, NULL, 0, NULL));
+
+	if (!thread) {
+		key_capture_free();
+		return false;
+	}
+
+	return true;
+}
+
+void key_capture_window(HWND hwnd)
+{
+	if (!keyboard || !hwnd) {
+		return;
+	}
+
+	/* the cooperative level can only be changed while unacquired */
+	keyboard->Unacquire();
+	keyboard->SetCooperativeLevel(hwnd, DISCL_FOREGROUND | DISCL_NONEXCLUSIVE);
+	acquire();
+
+	window_hook_add(capture_hook);
+	window_hooks_attach(hwnd);
+}
+
+bool key_capture_start(key_capture_cb_t cb, void *data)
+{
+	DWORD n = INFINITE;
+
+	if (!keyboard) {
+		return false;
+	}
+
+	callback = cb;
+	callbackData = data;
+	armed = true;
+
+	QueryPerformanceCounter(&armedTime);
+	armedCpu = process_cpu_time();
+
+	acquire();
+
+	/* drop whatever is left from an earlier capture; keys that are already
+	 * held don't count as pressed */
+	keyboard->GetDeviceData(sizeof(DIDEVICEOBJECTDATA), NULL, &n, 0);
+	keys.clear();
+	snapshot();
+	keys.clear_edges();
+
+	return true;
+}
+
+void key_capture_stop(void)
+{
+	armed = false;
+
+	if (keyboard) {
+		/* no more events until the next capture */
+		keyboard->Unacquire();
+	}
+}
+
+void key_capture_free(void)
+{
+	key_capture_stop();
+
+	if (thread) {
+		SetEvent(quitEvent);
+		WaitForSingleObject(thread, INFINITE);
+		CloseHandle(thread);
+		thread = NULL;
+	}
+
+	if (keyboard) {
+		keyboard->SetEventNotification(NULL);
+		keyboard->Release();
+		keyboard = NULL;
+	}
+
+	if (directInput) {
+		directInput->Release();
+		directInput = NULL;
+	}
+
+	if (keyEvent) {
+		CloseHandle(keyEvent);
+		keyEvent = NULL;
+	}
+
+	if (quitEvent) {
+		CloseHandle(quitEvent);
+		quitEvent = NULL;
+	}
+}
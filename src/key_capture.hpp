@@ -0,0 +1,75 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Key capture for the key binding buttons.
+ *
+ * The keyboard is opened once as a buffered DirectInput device.  It is only
+ * acquired while a button waits for a key; DirectInput then signals an event
+ * object, a worker thread sleeping on it forwards the wakeup to the main
+ * thread with Fl::awake() and the buffered key presses are read there.  No
+ * thread polls the keyboard.
+ *
+ * The key presses are tracked in a keyState, so the key that went down first
+ * is reported even if several keys are held.  Presses that DirectInput
+ * dropped (buffer overflow, lost input) are found by comparing a
+ * GetDeviceState() snapshot with the tracked state.
+ *
+ * The device uses the foreground cooperative level, so DirectInput drops it
+ * when the window is deactivated; it is acquired again on WM_ACTIVATE.
+ *
+ * The delay between the key press and its delivery and the CPU usage while
+ * waiting are recorded as trace counters.
+ *
+ * Fl::lock() must have been called before (topology_init() does that).
+ * Except for the worker thread everything here runs on the main thread.
+ */
+
+#ifndef KEY_CAPTURE_HPP
+#define KEY_CAPTURE_HPP
+
+#include "native_window.hpp"
+
+typedef unsigned char uchar;
+
+/* called on the main thread with the DirectInput code of the key */
+typedef void (*key_capture_cb_t)(uchar dxkey, void *data);
+
+/* create the DirectInput device and the worker thread */
+bool key_capture_init(void);
+
+/* bind the device to a window; call again if the window was recreated */
+void key_capture_window(nativeWindow hwnd);
+
+/* wait for the next key press that isn't ignored by the configuration
+ * (Escape is reported); `cb' is called once */
+bool key_capture_start(key_capture_cb_t cb, void *data);
+
+/* stop waiting without reporting a key */
+void key_capture_stop(void);
+
+/* stop the worker thread and release the DirectInput objects */
+void key_capture_free(void);
+
+#endif  /* KEY_CAPTURE_HPP */
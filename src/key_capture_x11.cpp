@@ -0,0 +1,146 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* The X11 version of the key capture.  While a button waits for a key every
+ * event goes through capture_dispatch() before FLTK hands it to a widget;
+ * the hardware key code of a key press is the evdev code plus 8 on every
+ * X server that uses the evdev or libinput driver, and is translated to the
+ * DirectInput code with the same table the game sees through Wine.  The key
+ * code doesn't depend on the keyboard layout, just like the DirectInput one.
+ *
+ * Keys that are already held when the capture starts don't count, and with
+ * detectable auto repeat a held key doesn't send further presses. */
+
+#include <FL/Fl.H>
+#include <FL/x.H>
+#include <X11/XKBlib.h>
+#include <X11/Xlib.h>
+
+#include <string.h>
+
+#include "configuration.hpp"
+#include "evdev_keys.hpp"
+#include "key_capture.hpp"
+#include "trace.hpp"
+
+
+static key_capture_cb_t callback = NULL;
+static void *callbackData = NULL;
+static bool armed = false;
+
+static char held[32];  /* XQueryKeymap() bits of the X key codes */
+
+
+static bool is_held(unsigned int keycode)
+{
+	return (held[(keycode / 8) & 31] & (1 << (keycode % 8))) != 0;
+}
+
+static void set_held(unsigned int keycode, bool down)
+{
+	if (down) {
+		held[(keycode / 8) & 31] |= static_cast<char>(1 << (keycode % 8));
+	} else {
+		held[(keycode / 8) & 31] &= static_cast<char>(~(1 << (keycode % 8)));
+	}
+}
+
+static int capture_dispatch(int event, Fl_Window *w)
+{
+	if (!armed || !fl_xevent || (fl_xevent->type != KeyPress && fl_xevent->type != KeyRelease)) {
+		return Fl::handle_(event, w);
+	}
+
+	unsigned int keycode = fl_xevent->xkey.keycode;
+	bool down = (fl_xevent->type == KeyPress);
+	bool repeat = down && is_held(keycode);
+
+	set_held(keycode, down);
+
+	if (!down || repeat || keycode < EVDEV_X11_OFFSET) {
+		return 1;
+	}
+
+	uchar dx = evdev_to_dik(keycode - EVDEV_X11_OFFSET);
+
+	/* don't ignore escape */
+	if (dx == 0 || (dx != DIK_ESCAPE && configuration::isIgnoredKey(dx))) {
+		return 1;
+	}
+
+	trace_instant("key captured");
+	key_capture_stop();
+
+	if (callback) {
+		callback(dx, callbackData);
+	}
+
+	/* the key doesn't reach the widgets */
+	return 1;
+}
+
+bool key_capture_init(void)
+{
+	fl_open_display();
+
+	/* otherwise a held key sends a release before every repeated press */
+	XkbSetDetectableAutoRepeat(fl_display, True, NULL);
+
+	return true;
+}
+
+/* the events come through FLTK, no window needs to be bound */
+void key_capture_window(nativeWindow)
+{
+}
+
+bool key_capture_start(key_capture_cb_t cb, void *data)
+{
+	if (!fl_display) {
+		return false;
+	}
+
+	callback = cb;
+	callbackData = data;
+	armed = true;
+
+	/* keys that are already held don't count as pressed */
+	XQueryKeymap(fl_display, held);
+
+	Fl::event_dispatch(capture_dispatch);
+	return true;
+}
+
+void key_capture_stop(void)
+{
+	armed = false;
+	Fl::event_dispatch(NULL);
+}
+
+void key_capture_free(void)
+{
+	key_capture_stop();
+	callback = NULL;
+	memset(held, 0, sizeof(held));
+}
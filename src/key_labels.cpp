@@ -0,0 +1,228 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#ifndef DIRECTINPUT_VERSION
+#define DIRECTINPUT_VERSION 0x0800
+#endif
+#include <dinput.h>
+#else
+#include "evdev_keys.hpp"
+#endif
+
+#include <vector>
+
+#include "key_labels.hpp"
+
+#define ARRLEN(x)  (sizeof(x) / sizeof(*x))
+
+
+typedef struct {
+	uchar dxkey;
+	const char *name;
+} keyName_t;
+
+typedef struct {
+	uintptr_t layout;
+	int limit;
+	char *label[256];  /* NULL until it's needed */
+} labelTable_t;
+
+
+/* prefer these labels over the ones of the layout */
+static const keyName_t numpadNames[] =
+{
+	{DIK_NUMPAD0, "Num 0"},
+	{DIK_NUMPAD1, "Num 1"},
+	{DIK_NUMPAD2, "Num 2"},
+	{DIK_NUMPAD3, "Num 3"},
+	{DIK_NUMPAD4, "Num 4"},
+	{DIK_NUMPAD5, "Num 5"},
+	{DIK_NUMPAD6, "Num 6"},
+	{DIK_NUMPAD7, "Num 7"},
+	{DIK_NUMPAD8, "Num 8"},
+	{DIK_NUMPAD9, "Num 9"},
+	{DIK_DECIMAL, "Num ."},
+	{DIK_NUMPADCOMMA, "Num ,"},
+	{DIK_DIVIDE, "Num /"},
+	{DIK_MULTIPLY, "Num *"},
+	{DIK_ADD, "Num +"},
+	{DIK_SUBTRACT, "Num -"},
+	{DIK_NUMPADEQUALS, "Num ="},
+	{DIK_NUMPADENTER, "Num Enter"}
+};
+
+/* used if the keyboard layout has no name for a key */
+// https://docs.microsoft.com/en-us/previous-versions/windows/desktop/ee418641(v%3Dvs.85)
+static const keyName_t keyNames[] =
+{
+	{DIK_ABNT_C1, "ABNT C1"},
+	{DIK_ABNT_C2, "ABNT C2"},
+	{DIK_APOSTROPHE, "'"},
+	{DIK_AT, "@"},
+	{DIK_AX, "AX"},
+	{DIK_BACK, "Back"},
+	{DIK_COLON, ":"},
+	{DIK_DELETE, "Delete"},
+	{DIK_DOWN, "Down"},
+	{DIK_END, "End"},
+	{DIK_F1, "F1"},
+	{DIK_F2, "F2"},
+	{DIK_F3, "F3"},
+	{DIK_F4, "F4"},
+	{DIK_F5, "F5"},
+	{DIK_F6, "F6"},
+	{DIK_F7, "F7"},
+	{DIK_F8, "F8"},
+	{DIK_F9, "F9"},
+	{DIK_F10, "F10"},
+	{DIK_F11, "F11"},
+	{DIK_F12, "F12"},
+	{DIK_F13, "F13"},
+	{DIK_F14, "F14"},
+	{DIK_F15, "F15"},
+	{DIK_GRAVE, "`"},
+	{DIK_HOME, "Home"},
+	{DIK_INSERT, "Insert"},
+	{DIK_LCONTROL, "CTRL"},
+	{DIK_LEFT, "Left"},
+	{DIK_LMENU, "Alt"},
+	{DIK_LSHIFT, "Shift"},
+	{DIK_NEXT, "Page Down"},
+	{DIK_OEM_102, "OEM 102"},
+	{DIK_PAUSE, "Pause"},
+	{DIK_PRIOR, "Page Up"},
+	{DIK_RCONTROL, "Right CTRL"},
+	{DIK_RETURN, "Enter"},
+	{DIK_RIGHT, "Right"},
+	{DIK_RMENU, "Right Alt"},
+	{DIK_RSHIFT, "Right Shift"},
+	{DIK_SPACE, "Space"},
+	{DIK_SYSRQ, "SYSRQ"},
+	{DIK_TAB, "Tab"},
+	{DIK_UNDERLINE, "_"},
+	{DIK_UNLABELED, "UNLABELED"},
+	{DIK_UP, "Up"},
+	{DIK_YEN, "Yen"}
+};
+
+static std::vector<labelTable_t *> tables;
+static labelTable_t *last = NULL;  /* the table used last */
+
+
+static const char *find_name(const keyName_t *names, size_t count, uchar dx)
+{
+	for (size_t i = 0; i < count; ++i) {
+		if (names[i].dxkey == dx) {
+			return names[i].name;
+		}
+	}
+	return NULL;
+}
+
+static char *copy_label(const char *str)
+{
+	size_t len = strlen(str) + 1;
+	char *p = reinterpret_cast<char *>(malloc(len));
+
+	if (p) {
+		memcpy(p, str, len);
+	}
+	return p;
+}
+
+static char *make_label(uchar dx, int limit)
+{
+	char buf[128];
+	const char *name = find_name(numpadNames, ARRLEN(numpadNames), dx);
+
+	if (name) {
+		return copy_label(name);
+	}
+
+	if (key_label_make(dx, limit, buf, sizeof(buf))) {
+		return copy_label(buf);
+	}
+
+	name = find_name(keyNames, ARRLEN(keyNames), dx);
+
+	if (name) {
+		return copy_label(name);
+	}
+
+	snprintf(buf, sizeof(buf), "0x%X", dx);
+	return copy_label(buf);
+}
+
+static labelTable_t *find_table(uintptr_t layout, int limit)
+{
+	for (size_t i = 0; i < tables.size(); ++i) {
+		if (tables.at(i)->layout == layout && tables.at(i)->limit == limit) {
+			return tables.at(i);
+		}
+	}
+
+	labelTable_t *t = new labelTable_t;
+	t->layout = layout;
+	t->limit = limit;
+	memset(t->label, 0, sizeof(t->label));
+	tables.push_back(t);
+
+	return t;
+}
+
+const char *key_label(uchar dx, int limit)
+{
+	uintptr_t layout = key_labels_layout();
+
+	if (!last || last->layout != layout || last->limit != limit) {
+		last = find_table(layout, limit);
+	}
+
+	if (!last->label[dx]) {
+		last->label[dx] = make_label(dx, limit);
+	}
+
+	return last->label[dx];
+}
+
+void key_labels_clear(void)
+{
+	for (size_t i = 0; i < tables.size(); ++i) {
+		for (int j = 0; j < 256; ++j) {
+			free(tables.at(i)->label[j]);
+		}
+		delete tables.at(i);
+	}
+
+	tables.clear();
+	last = NULL;
+	key_labels_forget();
+}
@@ -0,0 +1,73 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Labels of the key binding buttons.
+ *
+ * Every keyboard layout (an HKL, or an XKB group on X11) and button width
+ * gets a table of 256 labels, one per DirectInput key.  A label is looked up
+ * in the layout the first time it's needed (GetKeyNameTextW() on Windows),
+ * converted to UTF-8 and shortened to fit; after that it's a table lookup.
+ * Tables are kept when the layout changes, so switching back and forth
+ * doesn't look anything up again.
+ *
+ * Numpad keys always get the "Num" labels, keys without a name get a fixed
+ * English one or their code.
+ *
+ * Everything here runs on the main thread.
+ */
+
+#ifndef KEY_LABELS_HPP
+#define KEY_LABELS_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "native_window.hpp"
+
+typedef unsigned char uchar;
+
+/* label of a DirectInput key shortened to `limit' pixels with the current
+ * fl_font(); the string stays valid until key_labels_clear() */
+const char *key_label(uchar dx, int limit);
+
+/* follow WM_INPUTLANGCHANGE of a window; `cb' is called after the keyboard
+ * layout changed and should fetch the labels again */
+void key_labels_watch(nativeWindow hwnd, void (*cb)(void *data), void *data);
+
+/* free all tables */
+void key_labels_clear(void);
+
+
+/* platform parts (key_labels_win32.cpp, key_labels_x11.cpp) */
+
+/* the current keyboard layout, looked up again after key_labels_forget() */
+uintptr_t key_labels_layout(void);
+void key_labels_forget(void);
+
+/* the layout's label of a key shortened to `limit' pixels, false if it
+ * has none */
+bool key_label_make(uchar dx, int limit, char *buf, size_t size);
+
+#endif  /* KEY_LABELS_HPP */
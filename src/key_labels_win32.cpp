@@ -0,0 +1,158 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <windows.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <FL/fl_draw.H>
+
+#include "key_labels.hpp"
+#include "startup_cache.hpp"
+#include "text_fit.hpp"
+#include "window_hooks.hpp"
+
+#define ARRLEN(x)  (sizeof(x) / sizeof(*x))
+
+
+static HKL layout = NULL;  /* current keyboard layout, NULL if unknown */
+
+static void (*callback)(void *) = NULL;
+static void *callbackData = NULL;
+
+
+/* convert UTF-16 to UTF-8; unpaired surrogates become U+FFFD and the output
+ * is cut at a character boundary if `size' is too small */
+static void utf16_to_utf8(const wchar_t *in, int len, char *out, size_t size)
+{
+	size_t n = 0;
+
+	for (int i = 0; i < len; ++i) {
+		uint32_t c = in[i];
+
+		/* ASCII */
+		if (c < 0x80) {
+			if (n + 1 >= size) {
+				break;
+			}
+			out[n++] = static_cast<char>(c);
+			continue;
+		}
+
+		if (c >= 0xD800 && c <= 0xDFFF) {
+			if (c <= 0xDBFF && i + 1 < len && in[i + 1] >= 0xDC00 && in[i + 1] <= 0xDFFF) {
+				c = 0x10000 + ((c - 0xD800) << 10) + (in[i + 1] - 0xDC00);
+				i++;
+			} else {
+				c = 0xFFFD;
+			}
+		}
+
+		if (c < 0x800) {
+			if (n + 2 >= size) {
+				break;
+			}
+			out[n++] = static_cast<char>(0xC0 | (c >> 6));
+		} else if (c < 0x10000) {
+			if (n + 3 >= size) {
+				break;
+			}
+			out[n++] = static_cast<char>(0xE0 | (c >> 12));
+			out[n++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+		} else {
+			if (n + 4 >= size) {
+				break;
+			}
+			out[n++] = static_cast<char>(0xF0 | (c >> 18));
+			out[n++] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+			out[n++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+		}
+		out[n++] = static_cast<char>(0x80 | (c & 0x3F));
+	}
+
+	out[n] = 0;
+}
+
+uintptr_t key_labels_layout(void)
+{
+	if (!layout) {
+		layout = GetKeyboardLayout(0);
+	}
+	return reinterpret_cast<uintptr_t>(layout);
+}
+
+void key_labels_forget(void)
+{
+	layout = NULL;
+}
+
+bool key_label_make(uchar dx, int limit, char *buf, size_t size)
+{
+	wchar_t wbuf[64];
+
+	if (cache_get_keylabel(dx, limit, buf, size)) {
+		return true;
+	}
+
+	/* bits 16-23 are the scan code, bit 24 is set for the extended keys
+	 * (DirectInput sets bit 7 for them) */
+	LONG lParam = static_cast<LONG>((dx & 0x7F) << 16 | ((dx & 0x80) ? 1 << 24 : 0));
+	int len = GetKeyNameTextW(lParam, wbuf, ARRLEN(wbuf));
+
+	if (len <= 0) {
+		return false;
+	}
+
+	utf16_to_utf8(wbuf, len, buf, size);
+
+	/* shorten label until it fits the widget */
+	buf[text_fit(buf, fl_font(), fl_size(), limit)] = 0;
+
+	cache_put_keylabel(dx, limit, buf);
+	return true;
+}
+
+static void labels_hook(UINT msg, WPARAM, LPARAM lParam)
+{
+	if (msg != WM_INPUTLANGCHANGE) {
+		return;
+	}
+
+	/* the labels in the startup cache belong to a single layout */
+	layout = reinterpret_cast<HKL>(lParam);
+	cache_refresh_keys();
+
+	if (callback) {
+		callback(callbackData);
+	}
+}
+
+void key_labels_watch(HWND hwnd, void (*cb)(void *data), void *data)
+{
+	callback = cb;
+	callbackData = data;
+
+	window_hook_add(labels_hook);
+	window_hooks_attach(hwnd);
+}
@@ -0,0 +1,128 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* The X11 parts of the key labels.  A key shows the character it types in
+ * the first shift level of the current XKB group, upper-cased, so "Z" is in
+ * the right place on a German layout.  Keys that don't type anything get the
+ * fixed English names of key_labels.cpp; the tables are per XKB group
+ * instead of per HKL. */
+
+#include <FL/fl_draw.H>
+#include <FL/x.H>
+#include <X11/XKBlib.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/keysym.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "evdev_keys.hpp"
+#include "key_labels.hpp"
+#include "text_fit.hpp"
+
+
+static int group = -1;  /* current XKB group, -1 if unknown */
+
+
+/* Unicode character of a keysym: Latin-1 keysyms are the character itself,
+ * the others that type something are 0x01000000 plus the character; 0 for
+ * keysyms that don't type anything printable */
+static unsigned long keysym_char(KeySym ks)
+{
+	if ((ks > 0x20 && ks < 0x7F) || (ks > 0xA0 && ks <= 0xFF)) {
+		return ks;
+	}
+	if ((ks & 0xFF000000) == 0x01000000 && (ks & 0x00FFFFFF) > 0xA0) {
+		return ks & 0x00FFFFFF;
+	}
+	return 0;
+}
+
+static void utf8_encode(unsigned long c, char *out)
+{
+	if (c < 0x80) {
+		*out++ = static_cast<char>(c);
+	} else if (c < 0x800) {
+		*out++ = static_cast<char>(0xC0 | (c >> 6));
+		*out++ = static_cast<char>(0x80 | (c & 0x3F));
+	} else if (c < 0x10000) {
+		*out++ = static_cast<char>(0xE0 | (c >> 12));
+		*out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+		*out++ = static_cast<char>(0x80 | (c & 0x3F));
+	} else {
+		*out++ = static_cast<char>(0xF0 | (c >> 18));
+		*out++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+		*out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+		*out++ = static_cast<char>(0x80 | (c & 0x3F));
+	}
+	*out = 0;
+}
+
+uintptr_t key_labels_layout(void)
+{
+	if (group == -1) {
+		XkbStateRec state;
+
+		group = (fl_display && XkbGetState(fl_display, XkbUseCoreKbd, &state) == Success) ? state.group : 0;
+	}
+	return static_cast<uintptr_t>(group);
+}
+
+void key_labels_forget(void)
+{
+	group = -1;
+}
+
+bool key_label_make(uchar dx, int limit, char *buf, size_t size)
+{
+	unsigned int code = dik_to_evdev(dx);
+	KeySym lower, upper;
+
+	/* a character is at most 4 bytes of UTF-8 */
+	if (code == 0 || !fl_display || size < 5) {
+		return false;
+	}
+
+	KeySym ks = XkbKeycodeToKeysym(fl_display, static_cast<KeyCode>(code + EVDEV_X11_OFFSET), group, 0);
+
+	XConvertCase(ks, &lower, &upper);
+	unsigned long c = keysym_char(upper);
+
+	if (c == 0) {
+		return false;
+	}
+
+	utf8_encode(c, buf);
+
+	/* shorten label until it fits the widget */
+	buf[text_fit(buf, fl_font(), fl_size(), limit)] = 0;
+	return true;
+}
+
+/* FLTK 1.3 doesn't pass on XKB events; the group is read again after
+ * key_labels_clear() */
+void key_labels_watch(nativeWindow, void (*)(void *), void *)
+{
+}
@@ -0,0 +1,155 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "cpu.h"
+#include "key_state.hpp"
+
+
+static inline int lowest_bit(uint32_t v)
+{
+#ifdef _MSC_VER
+	unsigned long n;
+	_BitScanForward(&n, v);
+	return static_cast<int>(n);
+#else
+	return __builtin_ctz(v);
+#endif
+}
+
+/* gathers the top bits of 8 bytes with one multiplication */
+static void key_state_mask_generic(const uchar *state, uint32_t *mask)
+{
+	for (int w = 0; w < KEY_STATE_WORDS; ++w) {
+		uint32_t m = 0;
+
+		for (int i = 0; i < 4; ++i) {
+			uint64_t v;
+			memcpy(&v, state + w * 32 + i * 8, 8);
+			v &= 0x8080808080808080ULL;
+			m |= static_cast<uint32_t>((v * 0x0002040810204081ULL) >> 56) << (i * 8);
+		}
+		mask[w] = m;
+	}
+}
+
+#ifdef CPU_X86
+/* movemask collects the top bit of 16 bytes at once */
+static CPU_TARGET_SSE2 void key_state_mask_sse2(const uchar *state, uint32_t *mask)
+{
+	const __m128i *p = reinterpret_cast<const __m128i *>(state);
+
+	for (int w = 0; w < KEY_STATE_WORDS; ++w, p += 2) {
+		uint32_t lo = static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(p)));
+		uint32_t hi = static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(p + 1)));
+		mask[w] = lo | hi << 16;
+	}
+}
+#endif
+
+void key_state_mask(const uchar *state, uint32_t *mask)
+{
+#ifdef CPU_X86
+	if (cpu_has_sse2()) {
+		key_state_mask_sse2(state, mask);
+		return;
+	}
+#endif
+	key_state_mask_generic(state, mask);
+}
+
+
+void keyState::clear()
+{
+	memset(_down, 0, sizeof(_down));
+	_heldN = 0;
+	clear_edges();
+}
+
+void keyState::clear_edges()
+{
+	memset(_pressed, 0, sizeof(_pressed));
+	memset(_released, 0, sizeof(_released));
+	_orderN = 0;
+}
+
+void keyState::key(uchar dx, bool down)
+{
+	uint32_t bit = 1u << (dx & 31);
+	int w = dx >> 5;
+
+	if (down) {
+		if (_down[w] & bit) {
+			/* auto-repeat */
+			return;
+		}
+		_down[w] |= bit;
+		_pressed[w] |= bit;
+		_held[_heldN++] = dx;
+
+		/* a key can be pressed again after it was released */
+		if (_orderN < sizeof(_order)) {
+			_order[_orderN++] = dx;
+		}
+		return;
+	}
+
+	if ((_down[w] & bit) == 0) {
+		return;
+	}
+	_down[w] &= ~bit;
+	_released[w] |= bit;
+
+	/* chords are short, keep them in order */
+	for (size_t i = 0; i < _heldN; ++i) {
+		if (_held[i] == dx) {
+			memmove(_held + i, _held + i + 1, _heldN - i - 1);
+			--_heldN;
+			break;
+		}
+	}
+}
+
+void keyState::update(const uchar *state)
+{
+	uint32_t now[KEY_STATE_WORDS];
+
+	key_state_mask(state, now);
+
+	for (int w = 0; w < KEY_STATE_WORDS; ++w) {
+		uint32_t diff = now[w] ^ _down[w];
+
+		/* a snapshot doesn't tell the order, lower codes come first */
+		while (diff != 0) {
+			int bit = lowest_bit(diff);
+			diff &= diff - 1;
+			key(static_cast<uchar>(w * 32 + bit), (now[w] >> bit) & 1);
+		}
+	}
+}
@@ -0,0 +1,94 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Keyboard state tracker for DirectInput key codes.
+ *
+ * Keys are kept as a 256 bit set.  State changes come either one at a time
+ * from buffered DirectInput events or as a full 256 byte GetDeviceState()
+ * snapshot.  A snapshot is turned into a bit set 16 keys at a time with SSE2
+ * (if the CPU has it) and compared word by word, so only changed keys cost
+ * anything.
+ *
+ * Keys pressed since the last clear_edges() are listed in the order they
+ * went down.  Keys that are held together (a chord) are listed in the same
+ * order.
+ */
+
+#ifndef KEY_STATE_HPP
+#define KEY_STATE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned char uchar;
+
+#define KEY_STATE_WORDS  (256 / 32)
+
+
+class keyState
+{
+private:
+	uint32_t _down[KEY_STATE_WORDS];
+	uint32_t _pressed[KEY_STATE_WORDS];
+	uint32_t _released[KEY_STATE_WORDS];
+
+	/* pressed since clear_edges() and currently held, both in press order */
+	uchar _order[256];
+	size_t _orderN;
+	uchar _held[256];
+	size_t _heldN;
+
+public:
+	keyState() { clear(); }
+
+	/* no keys held, no edges */
+	void clear();
+
+	/* forget the pressed and released keys, but not the held ones */
+	void clear_edges();
+
+	/* a single key went down or up */
+	void key(uchar dx, bool down);
+
+	/* a snapshot in the c_dfDIKeyboard format (bit 0x80 = held) */
+	void update(const uchar *state);
+
+	bool down(uchar dx) const     { return (_down[dx >> 5] >> (dx & 31)) & 1; }
+	bool pressed(uchar dx) const  { return (_pressed[dx >> 5] >> (dx & 31)) & 1; }
+	bool released(uchar dx) const { return (_released[dx >> 5] >> (dx & 31)) & 1; }
+
+	/* keys pressed since clear_edges(), oldest first */
+	size_t pressed_count() const    { return _orderN; }
+	uchar pressed_key(size_t i) const { return _order[i]; }
+
+	/* keys held right now, oldest first */
+	size_t chord_count() const    { return _heldN; }
+	uchar chord_key(size_t i) const { return _held[i]; }
+};
+
+/* set bit n of `mask' if state[n] has bit 0x80 set */
+void key_state_mask(const uchar *state, uint32_t *mask);
+
+#endif  /* KEY_STATE_HPP */
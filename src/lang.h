@@ -1,35 +0,0 @@
-const char *ui_Settings[] = { "Settings", "Einstellungen", "Ajustes", "Param" "\xC3\xA8" "tres", "Impostazioni", "\xE8\xA8\xAD\xE5\xAE\x9A" };
-//const char *ui_GraphicsSettings[] = { "Graphics settings", "Grafik-Einstellungen", "Configuraci" "\xC3\xB3" "n gr" "\xC3\xA1" "fica", "Param" "\xC3\xA8" "tres graphiques", "Impostazioni grafiche", "\xE3\x82\xB0\xE3\x83\xA9\xE3\x83\x95\xE3\x82\xA3\xE3\x83\x83\xE3\x82\xAF\xE3\x81\xAE\xE8\xA8\xAD\xE5\xAE\x9A" };
-const char *ui_GraphicsDevice[] = { "Graphics device", "Grafikkarte", "Dispositivo grafico", "P" "\xC3\xA9" "riph" "\xC3\xA9" "rique graphique", "Dispositivo grafico", "\xE3\x82\xB0\xE3\x83\xA9\xE3\x83\x95\xE3\x82\xA3\xE3\x83\x83\xE3\x82\xAF\xE3\x82\xB9\xE3\x83\x87\xE3\x83\x90\xE3\x82\xA4\xE3\x82\xB9" };
-const char *ui_Resolution[] = { "Resolution", "Aufl" "\xC3\xB6" "sung", "Resoluci" "\xC3\xB3" "n", "R" "\xC3\xA9" "solution", "Risoluzione", "\xE8\xA7\xA3\xE5\x83\x8F\xE5\xBA\xA6" };
-const char *ui_Fullscreen[] = { "Fullscreen", "Vollbild", "Pantalla completa", "Plein " "\xC3\xA9" "cran", "Schermo intero", "\xE3\x83\x95\xE3\x83\xAB\xE3\x82\xB9\xE3\x82\xAF\xE3\x83\xAA\xE3\x83\xBC\xE3\x83\xB3" };
-//const char *ui_AudioSettings[] = { "Audio settings", "Audio-Einstellungen", "Ajustes de audio", "Param" "\xC3\xA8" "tres audio", "Impostazioni audio", "\xE3\x82\xAA\xE3\x83\xBC\xE3\x83\x87\xE3\x82\xA3\xE3\x82\xAA\xE8\xA8\xAD\xE5\xAE\x9A" };
-//const char *ui_OutputDevice[] = { "Output device", "Ausgabeger" "\xC3\xA4" "t", "Dispositivo de salida", "P" "\xC3\xA9" "riph" "\xC3\xA9" "rique de sortie", "Dispositivo di uscita", "\xE5\x87\xBA\xE5\x8A\x9B\xE3\x83\x87\xE3\x83\x90\xE3\x82\xA4\xE3\x82\xB9" };
-const char *ui_Language[] = { "Language", "Sprache", "Idioma", "Langue", "Lingua", "\xE8\xA8\x80\xE8\xAA\x9E" };
-const char *ui_ControllerSelection[] = { "Controller selection", "Wahl der Steuerung", "Selecci" "\xC3\xB3" "n de controlador", "Choix de la manette", "Selezione controller", "\xE3\x82\xB3\xE3\x83\xB3\xE3\x83\x88\xE3\x83\xAD\xE3\x83\xBC\xE3\x83\xA9\xE3\x81\xAE\xE9\x81\xB8\xE6\x8A\x9E" };
-//const char *ui_AdditionalController[] = { "Additional controller", "Zus" "\xC3\xA4" "tzliche Controller", "Controlador adicional", "Manette suppl" "\xC3\xA9" "mentaire", "Controller aggiuntivo", "\xE8\xBF\xBD\xE5\x8A\xA0\xE3\x81\xAE\xE3\x82\xB3\xE3\x83\xB3\xE3\x83\x88\xE3\x83\xAD\xE3\x83\xBC\xE3\x83\xA9" };
-//const char *ui_ControllerNumber[] = { "Controller number", "Controller-Nummer", "Controlador n" "\xC3\xBA" "mero", "Num" "\xC3\xA9" "ro de manette", "Numero di controller", "\xE3\x82\xB3\xE3\x83\xB3\xE3\x83\x88\xE3\x83\xAD\xE3\x83\xBC\xE3\x83\xA9\xE7\x95\xAA\xE5\x8F\xB7" };
-//const char *ui_Layout[] = { "Layout", "Layout", "Interfaz", "Interface", "Disposizione", "\xE3\x81\xAE\xE3\x83\xAC\xE3\x82\xA4\xE3\x82\xA2\xE3\x82\xA6\xE3\x83\x88" };
-//const char *ui_ConfigurationLayout[] = { "Configuration Layout", "Steuerungskonfiguration", "Configuraci" "\xC3\xB3" "n de botones", "Configuration", "Configurazione", "\xE3\x83\xAC\xE3\x82\xA4\xE3\x82\xA2\xE3\x82\xA6\xE3\x83\x88\xE3\x81\xAE\xE8\xA8\xAD\xE5\xAE\x9A" };
-const char *ui_Movement[] = { "Movement", "Bewegung", "Movimiento", "D" "\xC3\xA9" "placement", "Movimento", "\xE7\xA7\xBB\xE5\x8B\x95" };
-const char *ui_Action[] = { "Action", "Aktion", "Acci" "\xC3\xB3" "n", "Action", "Azione", "\xE3\x82\xA2\xE3\x82\xAF\xE3\x82\xB7\xE3\x83\xA7\xE3\x83\xB3" };
-const char *ui_Up[] = { "Up", "Nach oben", "Arriba", "Haut", "Su", "\xE4\xB8\x8A" };
-const char *ui_Down[] = { "Down", "Nach unten", "Abajo", "Bas", "Gi" "\xC3\xB9", "\xE4\xB8\x8B" };
-const char *ui_Left[] = { "Left", "Links", "Izquierda", "Gauche", "Sinistra", "\xE5\xB7\xA6" };
-const char *ui_Right[] = { "Right", "Rechts", "Derecha", "Droite", "Destra", "\xE5\x8F\xB3" };
-const char *ui_Jump[] = { "Jump", "Sprung", "Saltar", "Sauter", "Saltare", "\xE3\x82\xB8\xE3\x83\xA3\xE3\x83\xB3\xE3\x83\x97" };
-const char *ui_Start[] = { "Start", "Start", "Iniciar", "D" "\xC3\xA9" "marrer", "Inizio", "\xE3\x82\xB9\xE3\x82\xBF\xE3\x83\xBC\xE3\x83\x88" };
-const char *ui_SaveSettings[] = { "Save settings and launch Sonic 4", "Einstellungen speichern und Sonic 4 starten", "Guardar la configuraci" "\xC3\xB3" "n e iniciar Sonic 4", "Sauvegarder les r" "\xC3\xA9" "glages et d" "\xC3\xA9" "marrer Sonic 4", "Salva le impostazioni e avvia Sonic 4", "\xE8\xA8\xAD\xE5\xAE\x9A\xE3\x82\x92\xE4\xBF\x9D\xE5\xAD\x98\xE3\x81\x97\xE3\x81\xA6\xE3\x82\xB2\xE3\x83\xBC\xE3\x83\xA0\xE3\x82\x92\xE3\x83\x97\xE3\x83\xAC\xE3\x82\xA4" };
-const char *ui_Player[] = { "Player", "Spieler", "Jugador", "Joueur", "Giocatore", "\xE3\x83\x97\xE3\x83\xAC\xE3\x82\xA4\xE3\x83\xA4\xE3\x83\xBC" };
-const char *ui_Select[] = { "Select", "W" "\xC3\xA4" "hlen", "Seleccionar", "S" "\xC3\xA9" "lectionnez", "Selezionare", "\xE6\xB1\xBA\xE5\xAE\x9A" };
-const char *ui_Back[] = { "Back", "Zur" "\xC3\xBC" "ck", "Volver", "Retour", "Indietro", "\xE6\x88\xBB\xE3\x82\x8B" };
-const char *ui_Keyboard[] = { "Keyboard", "Tastatur", "Teclado", "Clavier", "Tastiera", "\xE3\x82\xAD\xE3\x83\xBC\xE3\x83\x9C\xE3\x83\xBC\xE3\x83\x89" };
-const char *ui_Gamepad[] = { "Gamepad", "Gamepad", "Gamepad", "Gamepad", "Gamepad", "\xE3\x82\xB2\xE3\x83\xBC\xE3\x83\xA0\xE3\x83\x91\xE3\x83\x83\xE3\x83\x89" };
-const char *ui_ScoreAttack[] = { "Score Attack / Time Attack", "Punktangriff / Zeitangriff", "Por puntos / Contrarreloj", "Chasse aux points / Contre la montre", "Attacco al tempo / Attacco al punteggio", "\xE3\x82\xB9\xE3\x82\xB3\xE3\x82\xA2\xE3\x82\xA2\xE3\x82\xBF\xE3\x83\x83\xE3\x82\xAF" " / " "\xE3\x82\xBF\xE3\x82\xA4\xE3\x83\xA0\xE3\x82\xA2\xE3\x82\xBF\xE3\x83\x83\xE3\x82\xAF" };
-const char *ui_Press[] = { "Press!", "Dr" "\xC3\xBC" "cken!", "\xC2\xA1" "Pulsa!", "Presse!", "Premi!", "\xE3\x82\x92\xE6\x8A\xBC\xE3\x81\x97" "!" };
-const char *ui_ResetToDefault[] = { "Reset to Default Settings", "Auf Standard zur" "\xC3\xBC" "cksetzen", "Volver a configuraci" "\xC3\xB3" "n inicial", "R" "\xC3\xA9" "initialiser", "Ripristina predefinito", "\xE3\x83\x87\xE3\x83\x95\xE3\x82\xA9\xE3\x83\xAB\xE3\x83\x88\xE3\x81\xAB\xE3\x83\xAA\xE3\x82\xBB\xE3\x83\x83\xE3\x83\x88" };
-//const char *ui_Configuration[] = { "Configuration", "Konfiguration", "Configuraci" "\xC3\xB3" "n", "Configuration", "Configurazione", "\xE3\x82\xB3\xE3\x83\xB3\xE3\x83\x95\xE3\x82\xA3\xE3\x82\xAE\xE3\x83\xA5\xE3\x83\xAC\xE3\x83\xBC\xE3\x82\xB7\xE3\x83\xA7\xE3\x83\xB3" };
-//const char *ui_ConfigurationSaved[] = { "Configuration saved.", "Einstellungen gespeichert.", "Configuraci" "\xC3\xB3" "n guardada.", "Configuration sauvegard" "\xC3\xA9" "e.", "Configurazione salvata.", "\xE8\xA8\xAD\xE5\xAE\x9A\xE3\x82\x92\xE4\xBF\x9D\xE5\xAD\x98\xE3\x81\x97\xE3\x81\xBE\xE3\x81\x97\xE3\x81\x9F" "." };
-const char *ui_SuperSonic[] = { "Super Sonic", "Super Sonic", "Super Sonic", "Super Sonic", "Super Sonic", "\xE3\x82\xB9\xE3\x83\xBC\xE3\x83\x91\xE3\x83\xBC\xE3\x82\xBD\xE3\x83\x8B\xE3\x83\x83\xE3\x82\xAF" };
-const char *ui_Vibrate[] = { "Vibrate", "Vibration", "Vibraci" "\xC3\xB3" "n", "Vibration", "Vibrazione", "\xE3\x83\x90\xE3\x82\xA4\xE3\x83\x96" };
-//const char *ui_Leaderboards[] = { "Leaderboards", "Bestenlisten", "Marcadores", "Classements", "Classifiche", "\xE3\x83\xAA\xE3\x83\xBC\xE3\x83\x80\xE3\x83\xBC\xE3\x83\x9C\xE3\x83\xBC\xE3\x83\x89" };
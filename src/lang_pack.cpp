@@ -0,0 +1,67 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "lang_pack.hpp"
+
+
+bool lang_pack_open(const uint8_t *data, size_t size, uint32_t nameId, langPack &p)
+{
+	if (size < LANG_PACK_HEADER || size > LANG_PACK_MAX_SIZE || memcmp(data, LANG_PACK_MAGIC, 4) != 0) {
+		return false;
+	}
+
+	p.data = data;
+	p.count = lang_pack_rd32(data + 4);
+	p.size = lang_pack_rd32(data + 8);
+	p.offsets = data + LANG_PACK_HEADER;
+	p.checked = false;
+
+	if (p.count <= nameId || p.count > LANG_PACK_MAX_SIZE / 4 || p.size == 0 ||
+		LANG_PACK_HEADER + static_cast<uint64_t>(p.count) * 4 + p.size != size)
+	{
+		return false;
+	}
+
+	p.strings = reinterpret_cast<const char *>(data + LANG_PACK_HEADER) + p.count * 4;
+
+	/* the last string is terminated, so every offset inside the string data
+	 * is the start of a terminated string */
+	return (p.strings[p.size - 1] == 0 && lang_pack_offset(p, nameId) < p.size);
+}
+
+bool lang_pack_check(langPack &p)
+{
+	if (!p.checked) {
+		for (uint32_t i = 0; i < p.count; ++i) {
+			if (lang_pack_offset(p, i) >= p.size) {
+				return false;
+			}
+		}
+		p.checked = true;
+	}
+
+	return true;
+}
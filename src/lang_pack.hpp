@@ -0,0 +1,81 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Language packs.
+ *
+ * A pack holds the strings of one language, see ui_strings.hpp for the
+ * format.  This only looks at bytes that are already in memory; mapping the
+ * files is up to the caller, so it doesn't depend on Windows.
+ *
+ * lang_pack_open() only reads the header and the name of the language.
+ * The other offsets are checked by lang_pack_check() when the language is
+ * selected, so the pages of a pack that is never used aren't touched.
+ */
+
+#ifndef LANG_PACK_HPP
+#define LANG_PACK_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LANG_PACK_MAGIC     "SLL\x01"
+#define LANG_PACK_HEADER    12
+#define LANG_PACK_MAX_SIZE  (1024 * 1024)
+
+
+typedef struct {
+	const uint8_t *data;
+	uint32_t count;
+	uint32_t size;
+	const uint8_t *offsets;  /* uint32 little endian */
+	const char *strings;
+	bool checked;  /* all offsets are valid */
+} langPack;
+
+/* check the header of `size' bytes of pack data and the offset of string
+ * `nameId', the name of the language */
+bool lang_pack_open(const uint8_t *data, size_t size, uint32_t nameId, langPack &p);
+
+/* check all offsets once; returns false if the pack is broken */
+bool lang_pack_check(langPack &p);
+
+/* the packs are little endian on every machine */
+inline uint32_t lang_pack_rd32(const uint8_t *p)
+{
+	return p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+inline uint32_t lang_pack_offset(const langPack &p, uint32_t id)
+{
+	return lang_pack_rd32(p.offsets + id * 4);
+}
+
+/* a string of a checked pack, or NULL if the pack doesn't have it */
+inline const char *lang_pack_str(const langPack &p, uint32_t id)
+{
+	return (id < p.count) ? p.strings + lang_pack_offset(p, id) : NULL;
+}
+
+#endif  /* LANG_PACK_HPP */
@@ -22,13 +22,21 @@
  * SOFTWARE.
  */
 
+#ifdef _WIN32
 #include <windows.h>
+#include <psapi.h>
 #include <shellapi.h>
 
 #ifndef DIRECTINPUT_VERSION
 #define DIRECTINPUT_VERSION 0x0800
 #endif
 #include <dinput.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <unistd.h>
+#endif
 
 #include <FL/Fl.H>
 #include <FL/Fl_Box.H>
@@ -37,31 +45,33 @@
 #include <FL/Fl_Choice.H>
 #include <FL/Fl_Group.H>
 #include <FL/Fl_Tabs.H>
-#include <FL/Fl_PNG_Image.H>
 #include <FL/Fl_Double_Window.H>
+#include <FL/fl_ask.H>
 #include <FL/fl_draw.H>
+#include <FL/x.H>
 
 #include <algorithm>
-#include <string>
 #include <vector>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wchar.h>
 
-#ifdef __GNUC__
-#include "images.h"
-#else
-#include "../Obj/images.h"
-#endif
-
-#include "lang.h"
 #include "configuration.hpp"
-
-// https://blogs.msdn.microsoft.com/oldnewthing/20041025-00/?p=37483
-// https://stackoverflow.com/a/557859
-EXTERN_C IMAGE_DOS_HEADER __ImageBase;
-#define HINST_THISCOMPONENT  reinterpret_cast<HINSTANCE>(&__ImageBase)
+#include "cpu.h"
+#include "display_topology.hpp"
+#include "image_registry.hpp"
+#include "key_capture.hpp"
+#include "key_labels.hpp"
+#include "key_state.hpp"
+#include "pad_monitor.hpp"
+#include "prefetch.hpp"
+#include "startup_cache.hpp"
+#include "text_fit.hpp"
+#include "text_fit_samples.hpp"
+#include "trace.hpp"
+#include "ui_strings.hpp"
 
 #define MAX_PATH_LENGTH      4096
 #define STRINGIFY(x)         #x
@@ -71,27 +81,10 @@ EXTERN_C IMAGE_DOS_HEADER __ImageBase;
 #define MENUITEM(x)          { x, 0,0,0,0, FL_NORMAL_LABEL, FL_HELVETICA, LS, 0 }
 #define ARRLEN(x)            (sizeof(x) / sizeof(*x))
 
+#ifndef _WIN32
+#define stricmp              strcasecmp
+#endif
 
-typedef struct {
-	uchar dxkey;
-	const char *name;
-} keyList_t;
-
-
-class DirectInput
-{
-private:
-	IDirectInput8 *m_directInput = NULL;
-	IDirectInputDevice8 *m_keyboard = NULL;
-
-public:
-	unsigned char m_keyboardState[256] = { 0 };
-
-	DirectInput() {}
-
-	bool init();
-	bool ReadKeyboard();
-};
 
 class MyChoice : public Fl_Choice
 {
@@ -114,6 +107,9 @@ public:
 	void menu(const Fl_Menu_Item *m);
 	Fl_Menu_Item *menu() { return _menu; }
 
+	/* use a menu without copying it; it must stay valid while it's shown */
+	void view(Fl_Menu_Item *m);
+
 	int handle(int event);
 };
 
@@ -123,6 +119,8 @@ private:
 	configuration *_config = NULL;
 	int _keytype = KEYUP;
 
+	static void unflash_cb(void *v);
+
 public:
 	kbButton(int X, int Y, int W, int H)
 		: Fl_Button(X, Y, W, H, NULL)
@@ -131,6 +129,10 @@ public:
 		clear_visible_focus();
 	}
 
+	~kbButton() {
+		Fl::remove_timeout(unflash_cb, this);
+	}
+
 	/* get/set pointer to a configuration */
 	void config(configuration *c) { _config = c; }
 	configuration *config() { return _config; }
@@ -146,22 +148,59 @@ public:
 	uchar dxkey() {
 		return _config ? _config->key(_keytype) : 0;
 	}
+
+	/* highlight the button for a moment, e.g. when its key was swapped */
+	void flash();
 };
 
 class PadBox : public Fl_Box
 {
 private:
 	const int _minW = 50;
+	bool _alignRight;
 	int measure_width(void);
 
 public:
 	PadBox(int X, int Y, int H, const char *L = NULL, Fl_Align align = FL_ALIGN_LEFT);
+
+	/* resize to the width of the label; call after the label was changed */
+	void fit(void);
+};
+
+/* live state and timing of the first connected XInput controller;
+ * the controllers are only polled while this is visible */
+class PadView : public Fl_Widget
+{
+private:
+	uint32_t _painted = 0;   /* state changes seen at the last paint */
+	double _latency = 0;     /* poll-to-paint of the last painted change in ms */
+	double _latencyMax = 0;
+
+	static void update_cb(void *v) {
+		reinterpret_cast<PadView *>(v)->redraw();
+	}
+
+	void draw_buttons(const pad_status_t &s, int X, int Y);
+	void draw_histogram(const pad_status_t &s, int X, int Y, int W, int H);
+
+public:
+	PadView(int X, int Y, int W, int H)
+		: Fl_Widget(X, Y, W, H, NULL)
+	{
+		box(FL_BORDER_BOX);
+		color(FL_WHITE);
+		labelsize(LS);
+	}
+
+	int handle(int event);
+	void draw();
 };
 
 class MyWindow : public Fl_Double_Window
 {
 private:
 	kbButton *_but = NULL;
+	bool _painted = false;
 
 public:
 	MyWindow(int W, int H, const char *L = NULL)
@@ -173,113 +212,128 @@ public:
 	void but(kbButton *o) { _but = o; }
 	kbButton *but() { return _but; }
 
+	/* called with the key that was pressed for the associated kbButton */
+	void captured(uchar dxNew);
+
 	int handle(int event);
+	void draw();
 };
 
 
-static void startWindow(bool restart, int setX, int setY);
+/* a widget whose label is one of the translated strings */
+typedef struct {
+	Fl_Widget *widget;
+	ui_id id;
+} boundLabel_t;
+
+
+static void createWindow(void);
+static void setLabels(void);
+static void refreshKeyLabels(void * = NULL);
 
 static configuration *config = NULL;
-static DirectInput *directinput = NULL;
 static MyWindow *win = NULL;
 static Fl_Menu_Item *resItems = NULL;
+static MyChoice *resChoice = NULL;
+static Fl_Menu_Item *devItems = NULL;
+static MyChoice *devChoice = NULL;
 static Fl_Group *g2_keyboard, *g2_gamepad;
 static kbButton *btUp, *btDown, *btLeft, *btRight, *btA, *btB, *btX, *btY, *btStart;
-
-#define IMAGE(x)  static Fl_PNG_Image x(NULL, x##_png, sizeof(x##_png))
-IMAGE(arrow_01);
-IMAGE(arrow_02);
-IMAGE(arrow_03);
-IMAGE(arrow_04);
-IMAGE(back1);
-IMAGE(back2);
-IMAGE(back3);
-IMAGE(button_01);
-IMAGE(button_02);
-IMAGE(button_03);
-IMAGE(button_04);
-IMAGE(button_05);
-IMAGE(pad_controls_v02);
-#undef IMAGE
+static MyChoice *conChoice = NULL;
+static std::vector<boundLabel_t> boundLabels;
+static char playerLabel[128], jumpBackLabel[128], jumpSelectLabel[128];
 
 static int rv = 0;
-static unsigned int lang = 0;
-
-static wchar_t moduleRootDir[MAX_PATH_LENGTH];
-static wchar_t confFile[MAX_PATH_LENGTH];
+static bool traceExit = false;
+static bool saveExit = false;
+static bool quickBootTime = false;
+static bool sessionMemory = false;
+static bool prefetchStats = false;
+static bool launch = false;
+
+static confChar moduleRootDir[MAX_PATH_LENGTH];
+static confChar confFile[MAX_PATH_LENGTH];
+static confChar cacheFile[MAX_PATH_LENGTH];
+
+#ifndef _WIN32
+/* the command after "--" that would start the game (Steam's %command%)
+ * and the position of the .exe in it, -1 if there is none */
+static std::vector<char *> gameCommand;
+static int gameExe = -1;
+static const char *gameDir = NULL;
+#endif
 
-static const Fl_Menu_Item langItems[] =
-{
-	MENUITEM("English"),
-	MENUITEM("Deutsch"),
-	MENUITEM("Espa" "\xC3\xB1" "ol"),  /* Español */
-	MENUITEM("Fran" "\xC3\xA7" "ais"),  /* Français */
-	MENUITEM("Italiano"),
-	MENUITEM("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E"),  /* Japanese */
-	{0}
+static Fl_Menu_Item *langItems = NULL;
+
+/* trace event names of the actions that gave up a key, indexed by KEYxxx */
+static const char * const keySwapNames[KEYSTART + 1] = {
+	NULL,
+	"key swapped from Up",
+	"key swapped from Down",
+	"key swapped from Left",
+	"key swapped from Right",
+	"key swapped from A",
+	"key swapped from B",
+	"key swapped from X",
+	"key swapped from Y",
+	"key swapped from Start"
 };
 
 
-// https://www.daemonology.net/blog/2008-06-05-faster-utf8-strlen.html
-static void strip_last_utf8_char(char *s)
+/* the button of an action (KEYxxx) */
+static kbButton *keyButton(int type)
 {
-	int i = 0;
-	int last_char = 0;
-
-	/* bytes 0xC0 through 0xFF are the first byte
-	 * of a UTF-8 multi-byte character */
-	while (s[i]) {
-		if ((s[i] & 0xC0) != 0x80) {
-			last_char = i;
-		}
-		i++;
+	switch (type) {
+	case KEYUP: return btUp;
+	case KEYDOWN: return btDown;
+	case KEYLEFT: return btLeft;
+	case KEYRIGHT: return btRight;
+	case KEYA: return btA;
+	case KEYB: return btB;
+	case KEYX: return btX;
+	case KEYY: return btY;
+	case KEYSTART: return btStart;
+	default: break;
 	}
-
-	s[last_char] = 0;
+	return NULL;
 }
 
-bool DirectInput::init()
+/* a key was pressed while a kbButton was armed */
+void MyWindow::captured(uchar dxNew)
 {
-	if (DirectInput8Create(HINST_THISCOMPONENT, DIRECTINPUT_VERSION, IID_IDirectInput8, reinterpret_cast<LPVOID *>(&m_directInput), NULL) != DI_OK)	{
-		return false;
-	}
+	kbButton *bt = but();
 
-	if (m_directInput->CreateDevice(GUID_SysKeyboard, &m_keyboard, NULL) != DI_OK) {
-		return false;
+	if (!bt) {
+		return;
 	}
 
-	if (m_keyboard->SetDataFormat(&c_dfDIKeyboard) != DI_OK) {
-		return false;
-	}
+	if (bt->config()) {
+		/* a key that is already used by another action is swapped with the
+		 * old key of this one; Escape and other ignored keys just cancel */
+		int owner = bt->config()->bindKey(dxNew, bt->keytype(), true);
 
-	if (m_keyboard->Acquire() != DI_OK) {
-		return false;
-	}
+		refreshKeyLabels();
 
-	return true;
-}
-
-bool DirectInput::ReadKeyboard()
-{
-	memset(m_keyboardState, 0, sizeof(m_keyboardState));
+		/* show which action has the old key now */
+		if (owner != 0 && owner != bt->keytype()) {
+			kbButton *other = keyButton(owner);
 
-	HRESULT res = m_keyboard->GetDeviceState(sizeof(m_keyboardState), reinterpret_cast<LPVOID>(m_keyboardState));
+			trace_instant(keySwapNames[owner]);
 
-	if (res != DI_OK) {
-		/* If the keyboard lost focus or was not acquired then try to get control back. */
-		if (res == DIERR_INPUTLOST || res == DIERR_NOTACQUIRED) {
-			m_keyboard->Acquire();
-		} else {
-			return false;
+			if (other) {
+				other->flash();
+			}
 		}
 	}
-	return true;
+
+	bt->value(0);
+	but(NULL);
+	redraw();
 }
 
 int MyWindow::handle(int event)
 {
 	int evX, evY, minX, minY, maxX, maxY;
-	uchar dxNew, dxOld;
 	kbButton *bt = but();
 
 	if (bt) {
@@ -294,6 +348,7 @@ int MyWindow::handle(int event)
 			maxY = bt->y() + bt->h();
 			/* if same button is pressed again -> restore */
 			if (evX>=minX && evX<=maxX && evY>=minY && evY<=maxY) {
+				key_capture_stop();
 				bt->dxkey(bt->dxkey());
 				bt->value(0);
 				but(NULL);
@@ -305,237 +360,62 @@ int MyWindow::handle(int event)
 		case FL_MOVE:
 		case FL_MOUSEWHEEL:
 			return 0;
-		}
-
-		if (bt->config() && event == FL_KEYDOWN) {
-			dxNew = dxOld = bt->dxkey();
-
-			if (directinput->init()) {
-				while (true) {
-					if (!directinput->ReadKeyboard()) {
-						continue;
-					}
-
-					for (unsigned int i = 0; i < sizeof(directinput->m_keyboardState); ++i) {
-						if ((directinput->m_keyboardState[i] & 128) == 0) {
-							continue;
-						}
-						dxNew = static_cast<uchar>(i);
-						break;
-					}
-
-					/* don't ignore escape */
-					if (dxNew != DIK_ESCAPE && configuration::isIgnoredKey(dxNew)) {
-						continue;
-					}
-
-					break;
-				}
-			}
-
-			if (dxNew == dxOld) {
-				/* just restore the previous button label */
-				bt->dxkey(dxOld);
-			} else {
-				configuration *cfg = bt->config();
-				int kt = bt->keytype();
-				std::vector<uchar> v;
-
-				for (int i = KEYUP; i <= KEYSTART; ++i) {
-					if (kt == i) {
-						v.push_back(dxNew);
-					} else {
-						v.push_back(cfg->key(i));
-					}
-				}
-
-				std::sort(v.begin(), v.end());
-
-				if (std::unique(v.begin(), v.end()) != v.end()) {
-					/* duplicate keys */
-					bt->dxkey(dxOld);
-				} else {
-					bt->dxkey(dxNew);
-				}
-			}
-
-			bt->value(0);
-			but(NULL);
-			redraw();
+		case FL_KEYDOWN:
+		case FL_KEYUP:
+		case FL_SHORTCUT:
+			/* the key is picked up by key_capture and passed to captured() */
+			return 1;
 		}
 	}
 
 	return Fl_Double_Window::handle(event);
 }
 
-void kbButton::dxkey(uchar n)
+static void traceExit_cb(void *)
 {
-	// https://docs.microsoft.com/en-us/previous-versions/windows/desktop/ee418641(v%3Dvs.85)
-	const keyList_t keyNames[] =
-	{
-		{DIK_ABNT_C1, "ABNT C1"},
-		{DIK_ABNT_C2, "ABNT C2"},
-		{DIK_APOSTROPHE, "'"},
-		{DIK_AT, "@"},
-		{DIK_AX, "AX"},
-		{DIK_BACK, "Back"},
-		{DIK_COLON, ":"},
-		{DIK_DELETE, "Delete"},
-		{DIK_DOWN, "Down"},
-		{DIK_END, "End"},
-		{DIK_F13, "F13"},
-		{DIK_F14, "F14"},
-		{DIK_F15, "F15"},
-		{DIK_GRAVE, "`"},
-		{DIK_HOME, "Home"},
-		{DIK_INSERT, "Insert"},
-		{DIK_LCONTROL, "CTRL"},
-		{DIK_LEFT, "Left"},
-		{DIK_LMENU, "Alt"},
-		{DIK_LSHIFT, "Shift"},
-		{DIK_NEXT, "Page Down"},
-		{DIK_OEM_102, "OEM 102"},
-		{DIK_PAUSE, "Pause"},
-		{DIK_PRIOR, "Page Up"},
-		{DIK_RCONTROL, "Right CTRL"},
-		{DIK_RETURN, "Enter"},
-		{DIK_RIGHT, "Right"},
-		{DIK_RMENU, "Right Alt"},
-		{DIK_RSHIFT, "Right Shift"},
-		{DIK_SYSRQ, "SYSRQ"},
-		{DIK_TAB, "Tab"},
-		{DIK_UNDERLINE, "_"},
-		{DIK_UNLABELED, "UNLABELED"},
-		{DIK_UP, "Up"},
-		{DIK_YEN, "Yen"}
-	};
+	win->hide();
+}
 
-	char buf[128] = { 0 };
-	uchar dxOld = dxkey();
-	uchar dx = n;
+static void saveExit_cb(void *)
+{
+	topology_wait(config->reslistDisplay());
+	rv = config->saveConfig() ? 0 : 1;
+	win->hide();
+}
 
-	label(NULL);
+void MyWindow::draw()
+{
+	Fl_Double_Window::draw();
 
-	/* prefer these labels over the localized ones */
-	switch (dx) {
-	case DIK_NUMPAD0:
-		label("Num 0");
-		break;
-	case DIK_NUMPAD1:
-		label("Num 1");
-		break;
-	case DIK_NUMPAD2:
-		label("Num 2");
-		break;
-	case DIK_NUMPAD3:
-		label("Num 3");
-		break;
-	case DIK_NUMPAD4:
-		label("Num 4");
-		break;
-	case DIK_NUMPAD5:
-		label("Num 5");
-		break;
-	case DIK_NUMPAD6:
-		label("Num 6");
-		break;
-	case DIK_NUMPAD7:
-		label("Num 7");
-		break;
-	case DIK_NUMPAD8:
-		label("Num 8");
-		break;
-	case DIK_NUMPAD9:
-		label("Num 9");
-		break;
-	case DIK_DECIMAL:
-		label("Num .");
-		break;
-	case DIK_NUMPADCOMMA:
-		label("Num ,");
-		break;
-	case DIK_DIVIDE:
-		label("Num /");
-		break;
-	case DIK_MULTIPLY:
-		label("Num *");
-		break;
-	case DIK_ADD:
-		label("Num +");
-		break;
-	case DIK_SUBTRACT:
-		label("Num -");
-		break;
-	case DIK_NUMPADEQUALS:
-		label("Num =");
-		break;
-	case DIK_NUMPADENTER:
-		label("Num Enter");
-		break;
-	default:
-		break;
-	}
+	if (!_painted) {
+		_painted = true;
+		trace_end("first paint");
+		trace_memory();
 
-	if (label()) {
-		/* label was set, now save the key value and quit */
-		if (_config) {
-			_config->key(dx, keytype());
+		if (traceExit) {
+			Fl::add_timeout(0.0, traceExit_cb);
+		} else if (saveExit) {
+			Fl::add_timeout(0.0, saveExit_cb);
 		}
-		return;
 	}
+}
+
+void kbButton::dxkey(uchar n)
+{
+	uchar dx = n;
 
 	if (dx == 0 || configuration::isIgnoredKey(dx)) {
-		dx = dxOld;
+		dx = dxkey();
 	}
 
-	/* save key value */
+	/* save key value; a key of another action is refused */
 	if (_config) {
 		_config->key(dx, keytype());
+		dx = dxkey();
 	}
 
-	if (GetKeyNameTextA(dx << 16, buf, sizeof(buf) - 1) > 0) {
-		fl_font(labelfont(), LS);
-
-		/* test multibyte utf8 character stripping */
-		/*
-		snprintf(buf, sizeof(buf) - 1, "%s",
-			// ÀàÁáÂâÄäÈèÉéÊêÌìÍíÎîÒòÓóÔôÖöÙùÚúÛûÜü
-			"\xC3\x80\xC3\xA0\xC3\x81\xC3\xA1\xC3\x82\xC3\xA2\xC3\x84\xC3\xA4\xC3\x88"
-			"\xC3\xA8\xC3\x89\xC3\xA9\xC3\x8A\xC3\xAA\xC3\x8C\xC3\xAC\xC3\x8D\xC3\xAD"
-			"\xC3\x8E\xC3\xAE\xC3\x92\xC3\xB2\xC3\x93\xC3\xB3\xC3\x94\xC3\xB4\xC3\x96"
-			"\xC3\xB6\xC3\x99\xC3\xB9\xC3\x9A\xC3\xBA\xC3\x9B\xC3\xBB\xC3\x9C\xC3\xBC"
-
-			// 今日はこんにちは今日はこんにちは
-			//"\xE4\xBB\x8A\xE6\x97\xA5\xE3\x81\xAF\xE3\x81\x93\xE3\x82\x93\xE3\x81\xAB"
-			//"\xE3\x81\xA1\xE3\x81\xAF\xE4\xBB\x8A\xE6\x97\xA5\xE3\x81\xAF\xE3\x81\x93"
-			//"\xE3\x82\x93\xE3\x81\xAB\xE3\x81\xA1\xE3\x81\xAF"
-		);
-		*/
-
-		int limit = w() - 2;
-
-		/* shrink label until it fits the widget */
-		if (static_cast<int>(fl_width(buf)) > limit) {
-			while (buf[0] != 0) {
-				strip_last_utf8_char(buf);
-				if (static_cast<int>(fl_width(buf)) <= limit) {
-					break;
-				}
-			}
-		}
-
-		copy_label(buf);
-	} else {
-		for (unsigned int i = 0; i < ARRLEN(keyNames); ++i) {
-			if (dx == keyNames[i].dxkey) {
-				label(keyNames[i].name);
-				return;
-			}
-		}
-
-		_snprintf_s(buf, sizeof(buf) - 1, "0x%X", dx);
-		copy_label(buf);
-	}
+	fl_font(labelfont(), LS);
+	label(key_label(dx, w() - 2));
 }
 
 void kbButton::keytype(int k)
@@ -554,20 +434,45 @@ void kbButton::keytype(int k)
 	dxkey(_config->key(_keytype));
 }
 
+void kbButton::flash()
+{
+	Fl::remove_timeout(unflash_cb, this);
+	color(FL_YELLOW);
+	redraw();
+	Fl::add_timeout(1.5, unflash_cb, this);
+}
+
+void kbButton::unflash_cb(void *v)
+{
+	kbButton *b = reinterpret_cast<kbButton *>(v);
+	b->color(FL_BACKGROUND_COLOR);
+	b->redraw();
+}
+
 PadBox::PadBox(int X, int Y, int H, const char *L, Fl_Align align)
-	: Fl_Box(X, Y, 1, H, L)
+	: Fl_Box(X, Y, 1, H, L),
+	  _alignRight(align == FL_ALIGN_RIGHT)
 {
-	int W = measure_width();
-	if (align == FL_ALIGN_RIGHT) {
-		X = X - (W - _minW);
-	}
-	resize(X, Y, W, H);
+	resize(X, Y, _minW, H);
+	fit();
 
 	box(FL_BORDER_BOX);
 	color(FL_WHITE);
 	labelsize(LS);
 }
 
+void PadBox::fit(void)
+{
+	int W = measure_width();
+
+	/* right aligned boxes keep their right edge */
+	if (_alignRight) {
+		resize(x() + w() - W, y(), W, h());
+	} else {
+		resize(x(), y(), W, h());
+	}
+}
+
 int PadBox::measure_width(void)
 {
 	int w = 0;
@@ -577,8 +482,11 @@ int PadBox::measure_width(void)
 	}
 
 	Fl_Box *o = new Fl_Box(0, 0, 0, 0, label());
-	fl_font(o->labelfont(), o->labelsize());
-	w = static_cast<int>(fl_width(o->label()));
+
+	if ((w = cache_get_width(o->label(), o->labelfont(), o->labelsize())) == -1) {
+		w = text_width(o->label(), o->labelfont(), o->labelsize());
+		cache_put_width(o->label(), o->labelfont(), o->labelsize(), w);
+	}
 
 	if (w < _minW) {
 		w = _minW;
@@ -588,79 +496,687 @@ int PadBox::measure_width(void)
 	return w;
 }
 
+int PadView::handle(int event)
+{
+	switch (event) {
+	case FL_SHOW:
+		if (visible_r()) {
+			_painted = 0;
+			_latencyMax = 0;
+			pad_monitor_start(update_cb, this);
+		}
+		break;
+	case FL_HIDE:
+		pad_monitor_stop();
+		break;
+	default:
+		break;
+	}
+
+	return Fl_Widget::handle(event);
+}
+
+void PadView::draw_buttons(const pad_status_t &s, int X, int Y)
+{
+	const struct { uint16_t mask; const char *name; } buttons[] = {
+		{ PAD_DPAD_UP, "Up" },
+		{ PAD_DPAD_DOWN, "Dn" },
+		{ PAD_DPAD_LEFT, "Lt" },
+		{ PAD_DPAD_RIGHT, "Rt" },
+		{ PAD_START, "St" },
+		{ PAD_BACK, "Bk" },
+		{ PAD_LEFT_THUMB, "LS" },
+		{ PAD_RIGHT_THUMB, "RS" },
+		{ PAD_LEFT_SHOULDER, "LB" },
+		{ PAD_RIGHT_SHOULDER, "RB" },
+		{ PAD_A, "A" },
+		{ PAD_B, "B" },
+		{ PAD_X, "X" },
+		{ PAD_Y, "Y" }
+	};
+
+	fl_font(FL_HELVETICA, 10);
+
+	for (size_t i = 0; i < ARRLEN(buttons); ++i) {
+		int bx = X + static_cast<int>(i) * 28;
+		bool down = (s.buttons & buttons[i].mask) != 0;
+
+		fl_color(down ? FL_DARK_GREEN : FL_LIGHT2);
+		fl_rectf(bx, Y, 26, 18);
+		fl_color(down ? FL_WHITE : FL_BLACK);
+		fl_draw(buttons[i].name, bx, Y, 26, 18, FL_ALIGN_CENTER);
+	}
+
+	/* triggers */
+	Y += 24;
+	fl_color(FL_LIGHT2);
+	fl_rectf(X, Y, 190, 8);
+	fl_rectf(X + 202, Y, 190, 8);
+	fl_color(FL_DARK_GREEN);
+	fl_rectf(X, Y, s.leftTrigger * 190 / 255, 8);
+	fl_rectf(X + 202, Y, s.rightTrigger * 190 / 255, 8);
+}
+
+void PadView::draw_histogram(const pad_status_t &s, int X, int Y, int W, int H)
+{
+	const char *labels[PAD_MONITOR_BUCKETS] = { "<1", "<2", "<4", "<8", "<16", "<32", "<64", "64+" };
+	int bw = W / PAD_MONITOR_BUCKETS;
+	uint32_t max = 1;
+
+	for (int i = 0; i < PAD_MONITOR_BUCKETS; ++i) {
+		max = std::max(max, s.histogram[i]);
+	}
+
+	fl_font(FL_HELVETICA, 10);
+
+	for (int i = 0; i < PAD_MONITOR_BUCKETS; ++i) {
+		int bh = static_cast<int>(static_cast<uint64_t>(s.histogram[i]) * (H - 14) / max);
+
+		fl_color(FL_DARK_BLUE);
+		fl_rectf(X + i * bw + 2, Y + H - 14 - bh, bw - 4, bh);
+		fl_color(FL_BLACK);
+		fl_draw(labels[i], X + i * bw, Y + H - 14, bw, 14, FL_ALIGN_CENTER);
+	}
+}
+
+void PadView::draw()
+{
+	pad_status_t s;
+	char buf[256];
+	int pad = 0;
+
+	draw_box();
+	fl_push_clip(x() + 1, y() + 1, w() - 2, h() - 2);
+
+	while (pad < PAD_MONITOR_PADS && !pad_monitor_status(pad, &s)) {
+		pad++;
+	}
+
+	if (pad == PAD_MONITOR_PADS) {
+		fl_font(FL_HELVETICA, LS);
+		fl_color(FL_BLACK);
+		fl_draw("No XInput controller connected", x(), y(), w(), h(), FL_ALIGN_CENTER);
+		fl_pop_clip();
+		return;
+	}
+
+	if (s.changes != _painted) {
+		_painted = s.changes;
+		_latency = pad_monitor_time() - s.changeTime;
+		_latencyMax = std::max(_latencyMax, _latency);
+	}
+
+	fl_font(FL_HELVETICA, LS);
+	fl_color(FL_BLACK);
+
+	snprintf(buf, sizeof(buf), "Controller %d, polled at %d Hz, %u changes",
+		pad + 1, pad_monitor_rate(), s.changes);
+	fl_draw(buf, x() + 8, y() + 16);
+
+	snprintf(buf, sizeof(buf), "Poll to paint %.1f ms (max %.1f), interval %.1f ms, jitter %.2f ms",
+		_latency, _latencyMax, s.intervalMean, s.intervalJitter);
+	fl_draw(buf, x() + 8, y() + 32);
+
+	draw_buttons(s, x() + 8, y() + 44);
+	draw_histogram(s, x() + w() - 248, y() + 6, 240, h() - 12);
+
+	fl_pop_clip();
+}
+
 void MyChoice::menu(const Fl_Menu_Item *m)
 {
 	/* make sure we have a local copy of the menu with write access */
 	Fl_Choice::copy(m);
 	_menu = const_cast<Fl_Menu_Item *>(Fl_Choice::menu());
+
+	/* the new menu may be shorter than the old one */
+	_prev = 0;
+}
+
+void MyChoice::view(Fl_Menu_Item *m)
+{
+	Fl_Choice::menu(m);
+	_menu = m;
+	_prev = 0;
+}
+
+int MyChoice::handle(int event)
+{
+	const Fl_Menu_Item *m;
+
+	if (!menu() || !menu()->text) {
+		return 0;
+	}
+
+	_menu[prev()].labelfont_ = FL_HELVETICA;
+	_menu[value()].labelfont_ = FL_HELVETICA;
+	prev(value());
+
+	if (event == FL_PUSH) {
+		/* highlight the currently selected value */
+		_menu[value()].labelfont_ = FL_HELVETICA_BOLD;
+
+		if (Fl::visible_focus()) {
+			Fl::focus(this);
+		}
+
+		if (Fl::scheme() || fl_contrast(textcolor(), FL_BACKGROUND2_COLOR) != textcolor()) {
+			m = menu()->pulldown(x(), y(), w(), h(), NULL, this);
+		} else {
+			Fl_Color c = color();
+			color(FL_BACKGROUND2_COLOR);
+			m = menu()->pulldown(x(), y(), w(), h(), NULL, this);
+			color(c);
+		}
+
+		if (!m) {
+			return 1;
+		}
+		
+		if (m != mvalue()) {
+			redraw();
+		}
+
+		picked(m);
+		return 1;
+	}
+
+	return Fl_Choice::handle(event);
+}
+
+#ifdef _WIN32
+
+static bool getModuleRootDir(void)
+{
+	wchar_t mod[MAX_PATH_LENGTH];
+	wchar_t *wcp = NULL;
+
+	if (!GetModuleFileNameW(NULL, mod, MAX_PATH_LENGTH)) {
+		return false;
+	}
+
+	if ((wcp = wcsrchr(mod, L'\\')) == NULL) {
+		return false;
+	}
+	*wcp = 0;
+
+	SecureZeroMemory(&moduleRootDir, MAX_PATH_LENGTH * sizeof(wchar_t));
+	SecureZeroMemory(&confFile, MAX_PATH_LENGTH * sizeof(wchar_t));
+	SecureZeroMemory(&cacheFile, MAX_PATH_LENGTH * sizeof(wchar_t));
+
+	wcscpy_s(moduleRootDir, MAX_PATH_LENGTH - 1, mod);
+	wcscpy_s(confFile, MAX_PATH_LENGTH - 1, mod);
+	wcscat_s(confFile, MAX_PATH_LENGTH - 1, L"\\main.conf");
+	wcscpy_s(cacheFile, MAX_PATH_LENGTH - 1, mod);
+	wcscat_s(cacheFile, MAX_PATH_LENGTH - 1, L"\\SonicLauncher.cache");
+
+	return true;
+}
+
+/* print to the console we were started from, or to the debugger output */
+static void printConsole(const char *text)
+{
+	DWORD written;
+
+	if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+		HANDLE h = CreateFileA("CONOUT$", GENERIC_WRITE, FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+
+		if (h != INVALID_HANDLE_VALUE) {
+			WriteFile(h, text, static_cast<DWORD>(strlen(text)), &written, NULL);
+			CloseHandle(h);
+		}
+		FreeConsole();
+	} else {
+		OutputDebugStringA(text);
+	}
+}
+
+#else
+
+/* Steam starts the launcher as `SonicLauncher -- %command%', where the command
+ * runs SonicLauncher.exe with Proton; the game directory is where that .exe
+ * is, unless -GameDir is given.  Without a command the launcher is expected
+ * to be in the game directory. */
+static bool getModuleRootDir(void)
+{
+	char dir[MAX_PATH_LENGTH];
+	char *p;
+	ssize_t n;
+
+	if (gameDir) {
+		snprintf(dir, sizeof(dir), "%s", gameDir);
+	} else if (gameExe != -1) {
+		snprintf(dir, sizeof(dir), "%s", gameCommand.at(gameExe));
+
+		if ((p = strrchr(dir, '/')) != NULL) {
+			*p = 0;
+		} else {
+			strcpy(dir, ".");
+		}
+	} else if ((n = readlink("/proc/self/exe", dir, sizeof(dir) - 1)) > 0) {
+		dir[n] = 0;
+		*strrchr(dir, '/') = 0;
+	} else {
+		return false;
+	}
+
+	snprintf(moduleRootDir, MAX_PATH_LENGTH, "%s", dir);
+	snprintf(confFile, MAX_PATH_LENGTH, "%s/main.conf", dir);
+	snprintf(cacheFile, MAX_PATH_LENGTH, "%s/SonicLauncher.cache", dir);
+
+	return true;
+}
+
+static void printConsole(const char *text)
+{
+	fputs(text, stdout);
+	fflush(stdout);
+}
+
+#endif  /* _WIN32 */
+
+/* -PrefetchStats: bytes prefetched while the window was open and, if it's
+ * known, the time from starting the game until it waited for input */
+static void printPrefetchStats(double readyMs)
+{
+	char buf[128];
+	double mib = prefetch_bytes() / (1024.0 * 1024.0);
+
+	if (readyMs < 0.0) {
+		snprintf(buf, sizeof(buf), "Prefetch: %.1f MiB read\n", mib);
+	} else {
+		snprintf(buf, sizeof(buf), "Prefetch: %.1f MiB read, game ready %.0f ms after CreateProcess\n", mib, readyMs);
+	}
+	printConsole(buf);
+
+	if (prefetch_atime_stale()) {
+		printConsole("Prefetch: the access time of Sonic_vis.exe wasn't updated, nothing was learned\n");
+	}
+}
+
+/* an error message without a parent window */
+static void showError(const char *title, const char *text)
+{
+#ifdef _WIN32
+	MessageBoxA(0, text, title, MB_ICONERROR|MB_OK);
+#else
+	fprintf(stderr, "%s: %s\n", title, text);
+
+	if (fl_display) {
+		fl_message_title(title);
+		fl_alert("%s", text);
+	}
+#endif
+}
+
+/* report the time between process creation and the return of CreateProcess() */
+static void printQuickBootTime(void)
+{
+	char buf[128];
+
+	if (snprintf(buf, sizeof(buf), "QuickBoot: %.3f ms to CreateProcess\n", trace_uptime_ms()) > 0) {
+		printConsole(buf);
+	}
+}
+
+/* load the language packs and select the language from the configuration;
+ * falls back to English */
+static void setLanguage(void)
+{
+	confChar dir[MAX_PATH_LENGTH];
+
+#ifdef _WIN32
+	wcscpy_s(dir, MAX_PATH_LENGTH - 1, moduleRootDir);
+	wcscat_s(dir, MAX_PATH_LENGTH - 1, L"\\lang");
+#else
+	snprintf(dir, MAX_PATH_LENGTH, "%s/lang", moduleRootDir);
+#endif
+	ui_lang_packs(dir);
+
+	if (!ui_lang_set(config->language())) {
+		ui_lang_set(0);
+	}
+}
+
+#ifdef _WIN32
+
+/* milliseconds from the performance counter, for the benchmark modes */
+static double benchMs(void)
+{
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER t;
+
+	if (freq.QuadPart == 0) {
+		QueryPerformanceFrequency(&freq);
+	}
+	QueryPerformanceCounter(&t);
+
+	return static_cast<double>(t.QuadPart) * 1000.0 / freq.QuadPart;
+}
+
+/* sorts the times */
+static double benchMedian(double *ms, int runs)
+{
+	std::sort(ms, ms + runs);
+	return ms[runs / 2];
+}
+
+/* the work at startup that is covered by the startup cache */
+static void cacheBenchWork(void)
+{
+	const char *labels[] = {
+		ui_str(UI_BACK), ui_str(UI_UP), ui_str(UI_RIGHT), ui_str(UI_LEFT), ui_str(UI_DOWN),
+		ui_str(UI_START), ui_str(UI_SUPER_SONIC), ui_str(UI_SCORE_ATTACK)
+	};
+	kbButton bt(0, 0, 89, 38);
+
+	config->initReslist(topology_name(config->reslistDisplay()));
+
+	for (int i = KEYUP; i <= KEYSTART; ++i) {
+		bt.dxkey(config->key(i));
+	}
+
+	for (size_t i = 0; i < ARRLEN(labels); ++i) {
+		PadBox box(0, 0, 18, labels[i]);
+	}
+}
+
+/* -CacheBench: time the cached startup work with an empty (cold) and with
+ * a freshly loaded (warm) cache and print the medians */
+static int cacheBench(void)
+{
+	const int runs = 21;
+	double cold[runs], warm[runs];
+	double t0;
+	char buf[256];
+
+	topology_init(false);
+	config = new configuration(confFile);
+	config->screenCount(topology_count());
+
+	if (!config->loadConfig()) {
+		config->loadDefaultConfig();
+	}
+	setLanguage();
+
+	for (int i = 0; i < runs; ++i) {
+		/* cold: fingerprints and everything else is computed */
+		cache_reset();
+		key_labels_clear();
+		t0 = benchMs();
+		cacheBenchWork();
+		cold[i] = benchMs() - t0;
+
+		cache_save();
+
+		/* warm: the cache file is read and the fingerprints are checked */
+		t0 = benchMs();
+		cache_load(cacheFile);
+		key_labels_clear();
+		cacheBenchWork();
+		warm[i] = benchMs() - t0;
+	}
+
+	_snprintf_s(buf, sizeof(buf), _TRUNCATE,
+		"startup cache, median of %d runs:\n"
+		"  cold: %.3f ms\n"
+		"  warm: %.3f ms\n", runs, benchMedian(cold, runs), benchMedian(warm, runs));
+	printConsole(buf);
+
+	delete config;
+	return 0;
+}
+
+/* how key capture used to find the key: the lowest held key code */
+static int keyBenchScan(const uchar *state)
+{
+	for (int i = 0; i < 256; ++i) {
+		if (state[i] & 128) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* milliseconds for one pass over all snapshots */
+static double keyBenchRun(bool scan, const uchar *states, int count, unsigned int *checksum)
+{
+	double t0 = benchMs();
+	keyState ks;
+
+	*checksum = 0;
+
+	for (int i = 0; i < count; ++i) {
+		const uchar *state = states + i * 256;
+
+		if (scan) {
+			*checksum += static_cast<unsigned int>(keyBenchScan(state) + 1);
+			continue;
+		}
+
+		ks.clear_edges();
+		ks.update(state);
+
+		for (size_t j = 0; j < ks.pressed_count(); ++j) {
+			*checksum += (ks.pressed_key(j) + 1u) * static_cast<unsigned int>(j + 1);
+		}
+	}
+
+	return benchMs() - t0;
+}
+
+/* -KeyBench: compare the scalar scan of a keyboard snapshot with the
+ * generic and the SSE2 keyState update and print the medians */
+static int keyBench(void)
+{
+	const int runs = 21;
+	const int count = 4096;
+	double scan[runs], generic[runs], simd[runs];
+	unsigned int sumScan, sumGeneric, sumSimd = 0;
+	uint32_t seed = 1;
+	char buf[256];
+
+	/* one key goes down or up per snapshot, at most 4 are held */
+	uchar *states = new uchar[count * 256];
+	int held = 0;
+	memset(states, 0, 256);
+
+	for (int i = 1; i < count; ++i) {
+		uchar *state = states + i * 256;
+		seed = seed * 1103515245 + 12345;
+
+		if (held == 4) {
+			memset(state, 0, 256);
+			held = 0;
+			continue;
+		}
+
+		memcpy(state, state - 256, 256);
+		state[(seed >> 16) & 0xFF] ^= 0x80;
+		held += (state[(seed >> 16) & 0xFF] != 0) ? 1 : -1;
+	}
+
+	for (int i = 0; i < runs; ++i) {
+		scan[i] = keyBenchRun(true, states, count, &sumScan);
+
+		cpu_disable_simd(1);
+		generic[i] = keyBenchRun(false, states, count, &sumGeneric);
+		cpu_disable_simd(0);
+
+		simd[i] = cpu_has_sse2() ? keyBenchRun(false, states, count, &sumSimd) : 0;
+	}
+
+	delete[] states;
+
+	if (cpu_has_sse2() && sumSimd != sumGeneric) {
+		printConsole("error: SSE2 and generic key state differ\n");
+		return 1;
+	}
+
+	_snprintf_s(buf, sizeof(buf), _TRUNCATE,
+		"key snapshots, median of %d runs (ns per snapshot):\n"
+		"  scalar scan: %.1f\n"
+		"  generic:     %.1f\n"
+		"  sse2:        %.1f\n", runs,
+		benchMedian(scan, runs) * 1e6 / count, benchMedian(generic, runs) * 1e6 / count,
+		benchMedian(simd, runs) * 1e6 / count);
+	printConsole(buf);
+
+	return 0;
+}
+
+// https://www.daemonology.net/blog/2008-06-05-faster-utf8-strlen.html
+static void strip_last_utf8_char(char *s)
+{
+	int i = 0;
+	int last_char = 0;
+
+	/* bytes 0xC0 through 0xFF are the first byte
+	 * of a UTF-8 multi-byte character */
+	while (s[i]) {
+		if ((s[i] & 0xC0) != 0x80) {
+			last_char = i;
+		}
+		i++;
+	}
+
+	s[last_char] = 0;
+}
+
+/* how labels used to be shortened: drop the last character and measure the
+ * whole label again until it fits; returns the length */
+static int fitStrip(const char *text, int limit)
+{
+	char buf[256];
+
+	strcpy_s(buf, sizeof(buf), text);
+
+	while (buf[0] != 0 && static_cast<int>(fl_width(buf)) > limit) {
+		strip_last_utf8_char(buf);
+	}
+
+	return static_cast<int>(strlen(buf));
+}
+
+/* -FitCheck: text_fit() must cut the sample labels at the same place as
+ * stripping characters does with the real font; the timing is done by
+ * `make bench-core' */
+static int fitCheck(void)
+{
+	char buf[128];
+	int count = 0;
+
+	fl_font(FL_HELVETICA, LS);
+
+	for (size_t i = 0; i < ARRLEN(textFitSamples); ++i) {
+		for (size_t j = 0; j < ARRLEN(textFitLimits); ++j, ++count) {
+			if (fitStrip(textFitSamples[i], textFitLimits[j]) !=
+				text_fit(textFitSamples[i], FL_HELVETICA, LS, textFitLimits[j]))
+			{
+				_snprintf_s(buf, sizeof(buf), _TRUNCATE, "error: text_fit() and stripping differ on sample %u\n",
+					static_cast<unsigned int>(i));
+				printConsole(buf);
+				return 1;
+			}
+		}
+	}
+
+	_snprintf_s(buf, sizeof(buf), _TRUNCATE, "label fitting: text_fit() agrees with fl_width() on %d labels\n", count);
+	printConsole(buf);
+
+	return 0;
+}
+
+/* private bytes of the process */
+static SIZE_T privateBytes(void)
+{
+	PROCESS_MEMORY_COUNTERS pmc;
+
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+		return 0;
+	}
+	return pmc.PagefileUsage;
 }
 
-int MyChoice::handle(int event)
+/* -SessionMemory: print what the launcher keeps while the game runs */
+static void printSessionMemory(void)
 {
-	const Fl_Menu_Item *m;
+	PROCESS_MEMORY_COUNTERS pmc;
+	char buf[128];
 
-	if (!menu() || !menu()->text) {
-		return 0;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) &&
+		snprintf(buf, sizeof(buf), "Session: %u KiB working set, %u KiB private while the game runs\n",
+			static_cast<unsigned>(pmc.WorkingSetSize / 1024), static_cast<unsigned>(pmc.PagefileUsage / 1024)) > 0)
+	{
+		printConsole(buf);
 	}
+}
 
-	_menu[prev()].labelfont_ = FL_HELVETICA;
-	_menu[value()].labelfont_ = FL_HELVETICA;
-	prev(value());
+/* -LangCycle: switch the language of a hidden window 100 times, print the
+ * switch latency and fail if memory kept growing */
+static int langCycle(void)
+{
+	const int switches = 100;
+	const SIZE_T tolerance = 64 * 1024;  /* heap noise */
+	double first[switches / 2], second[switches / 2];
+	SIZE_T before, after;
+	char buf[256];
 
-	if (event == FL_PUSH) {
-		/* highlight the currently selected value */
-		_menu[value()].labelfont_ = FL_HELVETICA_BOLD;
+	topology_init(false);
+	config = new configuration(confFile);
+	config->screenCount(topology_count());
 
-		if (Fl::visible_focus()) {
-			Fl::focus(this);
-		}
+	if (!config->loadConfig()) {
+		config->loadDefaultConfig();
+	}
 
-		if (Fl::scheme() || fl_contrast(textcolor(), FL_BACKGROUND2_COLOR) != textcolor()) {
-			m = menu()->pulldown(x(), y(), w(), h(), NULL, this);
-		} else {
-			Fl_Color c = color();
-			color(FL_BACKGROUND2_COLOR);
-			m = menu()->pulldown(x(), y(), w(), h(), NULL, this);
-			color(c);
-		}
+	setLanguage();
+	createWindow();
 
-		if (!m) {
-			return 1;
-		}
-		
-		if (m != mvalue()) {
-			redraw();
-		}
+	const unsigned int languages = ui_lang_count();
 
-		picked(m);
-		return 1;
+	/* every language once, so all glyphs and widths are cached */
+	for (unsigned int i = 0; i < languages; ++i) {
+		ui_lang_set(i);
+		setLabels();
 	}
 
-	return Fl_Choice::handle(event);
-}
+	before = privateBytes();
 
-static bool getModuleRootDir(void)
-{
-	wchar_t mod[MAX_PATH_LENGTH];
-	wchar_t *wcp = NULL;
+	for (int i = 0; i < switches; ++i) {
+		ui_lang_set(i % languages);
 
-	if (!GetModuleFileNameW(NULL, mod, MAX_PATH_LENGTH)) {
-		return false;
-	}
+		double t0 = benchMs();
+		setLabels();
+		double ms = benchMs() - t0;
 
-	if ((wcp = wcsrchr(mod, L'\\')) == NULL) {
-		return false;
+		if (i < switches / 2) {
+			first[i] = ms;
+		} else {
+			second[i - switches / 2] = ms;
+		}
 	}
-	*wcp = 0;
 
-	SecureZeroMemory(&moduleRootDir, MAX_PATH_LENGTH * sizeof(wchar_t));
-	SecureZeroMemory(&confFile, MAX_PATH_LENGTH * sizeof(wchar_t));
+	after = privateBytes();
 
-	wcscpy_s(moduleRootDir, MAX_PATH_LENGTH - 1, mod);
-	wcscpy_s(confFile, MAX_PATH_LENGTH - 1, mod);
-	wcscat_s(confFile, MAX_PATH_LENGTH - 1, L"\\main.conf");
+	_snprintf_s(buf, sizeof(buf), _TRUNCATE,
+		"language switches, median (ms):\n"
+		"  first %d:  %.3f\n"
+		"  second %d: %.3f\n"
+		"private bytes: %u KiB before, %u KiB after %d switches\n",
+		switches / 2, benchMedian(first, switches / 2), switches / 2, benchMedian(second, switches / 2),
+		static_cast<unsigned int>(before / 1024), static_cast<unsigned int>(after / 1024), switches);
+	printConsole(buf);
 
-	return true;
+	delete win;
+	delete config;
+
+	if (after > before + tolerance) {
+		printConsole("error: memory grew while switching languages\n");
+		return 1;
+	}
+
+	return 0;
 }
 
 static int launchGame(void)
@@ -677,12 +1193,53 @@ static int launchGame(void)
 	si.cb = sizeof(si);
 	SecureZeroMemory(&pi, sizeof(pi));
 
-	if (CreateProcessW(NULL, command, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi) == FALSE) {
+	trace_begin("CreateProcess");
+	BOOL created = CreateProcessW(NULL, command, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi);
+	trace_end("CreateProcess");
+
+	if (quickBootTime) {
+		printQuickBootTime();
+	}
+
+	if (created == FALSE) {
+		trace_write();
 		MessageBoxA(0, "Failed calling CreateProcess()", title, MB_ICONERROR|MB_OK);
 		return 1;
 	}
 
+	if (prefetchStats || trace_enabled()) {
+		/* the game is ready once it waits for input the first time;
+		 * compare with -NoPrefetch to see what the prefetch saved */
+		double start = trace_uptime_ms();
+
+		trace_begin("game ready");
+		WaitForInputIdle(pi.hProcess, 60000);
+		trace_end("game ready");
+
+		if (prefetchStats) {
+			printPrefetchStats(trace_uptime_ms() - start);
+		}
+	}
+
+	/* from here on the launcher only waits; give the freed heap and the
+	 * pages of code that won't run again back to the system */
+	trace_begin("trim");
+	HeapCompact(GetProcessHeap(), 0);
+	EmptyWorkingSet(GetCurrentProcess());
+	trace_end("trim");
+	trace_memory();
+	trace_write();
+
+	if (sessionMemory) {
+		printSessionMemory();
+	}
+
 	DWORD wait = WaitForSingleObject(pi.hProcess, INFINITE);
+	DWORD exitCode = 1;
+
+	if (wait == WAIT_OBJECT_0) {
+		GetExitCodeProcess(pi.hProcess, &exitCode);
+	}
 	CloseHandle(pi.hProcess);
 	CloseHandle(pi.hThread);
 
@@ -694,7 +1251,87 @@ static int launchGame(void)
 		MessageBoxA(0, "Process failed", title, MB_ICONERROR|MB_OK);
 	}
 
-	return wait;
+	/* Steam gets the exit code of the game */
+	return static_cast<int>(exitCode);
+}
+
+#else
+
+/* replace the launcher with the game, so Steam gets its exit code; the
+ * .exe in the command from Steam is swapped for Sonic_vis.exe, without a
+ * command the game is started with wine */
+static int launchGame(void)
+{
+	char exe[MAX_PATH_LENGTH];
+	std::vector<char *> args;
+	char wine[] = "wine";
+
+	snprintf(exe, sizeof(exe), "%s/Sonic_vis.exe", moduleRootDir);
+
+	if (gameCommand.empty()) {
+		args.push_back(wine);
+	}
+	for (size_t i = 0; i < gameCommand.size(); ++i) {
+		args.push_back(static_cast<int>(i) == gameExe ? exe : gameCommand.at(i));
+	}
+	if (gameExe == -1) {
+		args.push_back(exe);
+	}
+	args.push_back(NULL);
+
+	if (quickBootTime) {
+		printQuickBootTime();
+	}
+	if (prefetchStats) {
+		printPrefetchStats(-1.0);
+	}
+	if (sessionMemory) {
+		/* nothing of the launcher is left once the game runs */
+		printConsole("Session: 0 KiB, the launcher is replaced by the game\n");
+	}
+	trace_instant("exec");
+	trace_write();
+
+	/* the game must not inherit the connection to the X server */
+	if (fl_display) {
+		fcntl(ConnectionNumber(fl_display), F_SETFD, FD_CLOEXEC);
+	}
+
+	if (chdir(moduleRootDir) != 0 || execvp(args.at(0), args.data()) != 0) {
+		showError("Error: Sonic_vis.exe", strerror(errno));
+	}
+
+	return 1;
+}
+
+#endif  /* _WIN32 */
+
+/* -QuickBoot: launch the game without creating any GUI, enumerating the
+ * displays or touching the embedded images */
+static int quickBoot(void)
+{
+	trace_begin("checkConfig");
+	bool valid = configuration::checkConfig(confFile);
+	trace_end("checkConfig");
+
+	if (!valid) {
+		/* the default configuration needs the display modes */
+		topology_init(false);
+		config = new configuration(confFile);
+		config->screenCount(topology_count());
+		const modeTable *modes = topology_wait(config->reslistDisplay());
+
+		if (modes) {
+			config->setReslist(*modes);
+		}
+		config->loadDefaultConfig();
+		config->saveConfig();
+		delete config;
+		config = NULL;
+	}
+
+	trace_memory();
+	return launchGame();
 }
 
 static void setResolution_cb(Fl_Widget *o, void *)
@@ -703,41 +1340,106 @@ static void setResolution_cb(Fl_Widget *o, void *)
 	config->resN(b->value());
 }
 
-static void loadReslist(void)
+static const Fl_Menu_Item loadingItems[] =
+{
+	MENUITEM("..."),
+	{ 0 }
+};
+
+/* show the resolutions of the selected display, or a placeholder
+ * while they are still being enumerated */
+static void showReslist(void)
 {
+	uchar display = config->reslistDisplay();
+	const modeTable *list = topology_modes(display);
+
+	if (!list) {
+		resChoice->menu(loadingItems);
+		resChoice->value(0);
+		resChoice->deactivate();
+		resChoice->redraw();
+		return;
+	}
+
+	/* new configurations start with the desktop resolution */
+	config->setReslist(*list, topology_desktop_mode(display));
+
 	if (resItems) {
 		delete[] resItems;
 	}
-
-	config->initReslist();
 	resItems = new Fl_Menu_Item[config->resList.size() + 1];
 
 	for (size_t i = 0; i < config->resList.size(); ++i) {
-		resItems[i] = MENUITEM(config->resList.at(i).l);
+		resItems[i] = MENUITEM(config->resList.label(i));
 	}
 	resItems[config->resList.size()] = { 0 };
+
+	/* the items point into config->resList, no need for another copy */
+	resChoice->view(resItems);
+	resChoice->value(static_cast<int>(config->resN()));
+	resChoice->activate();
+	resChoice->redraw();
+}
+
+static void showDisplays(void)
+{
+	uchar count = topology_count();
+
+	if (devItems) {
+		delete[] devItems;
+	}
+	devItems = new Fl_Menu_Item[count + 1];
+
+	for (uchar i = 0; i < count; ++i) {
+		devItems[i] = MENUITEM(topology_label(i));
+	}
+	devItems[count] = { 0 };
+
+	devChoice->menu(devItems);
+	devChoice->value(config->display());
+	devChoice->redraw();
+}
+
+static void topology_cb(int event, uchar display, void *)
+{
+	if (!resChoice || !devChoice) {
+		return;
+	}
+
+	if (event == TOPOLOGY_CHANGED) {
+		/* a display was plugged in or removed */
+		config->screenCount(topology_count());
+
+		if (config->display() >= config->screenCount()) {
+			config->display(0);
+		}
+		showDisplays();
+		showReslist();
+	} else if (event == TOPOLOGY_MODES && display == config->reslistDisplay()) {
+		/* a worker thread finished enumerating the modes of a display */
+		showReslist();
+	}
 }
 
-static void setDisplay_cb(Fl_Widget *o, void *v)
+static void setDisplay_cb(Fl_Widget *o, void *)
 {
 	MyChoice *d = dynamic_cast<MyChoice *>(o);
-	MyChoice *r = reinterpret_cast<MyChoice *>(v);
 	config->display(static_cast<uchar>(d->value()));
-	loadReslist();
-	r->menu(resItems);
-	r->value(0);
-	r->redraw();
+	showReslist();
 }
 
 static void setLang_cb(Fl_Widget *o, void *)
 {
 	MyChoice *b = dynamic_cast<MyChoice *>(o);
-	int setX = win->x();
-	int setY = win->y();
-	lang = b->value();
-	config->language(static_cast<uchar>(lang));
-	win->hide();
-	startWindow(true, setX, setY);
+
+	if (!ui_lang_set(b->value())) {
+		/* broken language pack */
+		b->value(ui_lang());
+		return;
+	}
+
+	config->language(static_cast<uchar>(ui_lang()));
+	setLabels();
 }
 
 static void fullscreen_cb(Fl_Widget *, void *)
@@ -758,12 +1460,12 @@ static void setController_cb(Fl_Widget *o, void *v)
 
 	if (n == GAMEPAD_CTRLS) {
 		config->controls(n);
-		b->image(&back2);
+		b->image(get_image(IMG_BACK2));
 		g2_keyboard->hide();
 		g2_gamepad->show();
 	} else {
 		config->controls(KEYBOARD_CTRLS);
-		b->image(&back3);
+		b->image(get_image(IMG_BACK3));
 		g2_keyboard->show();
 		g2_gamepad->hide();
 	}
@@ -771,11 +1473,10 @@ static void setController_cb(Fl_Widget *o, void *v)
 	win->redraw();
 }
 
-static void setDefaultKeys_cb(Fl_Widget *, void *)
+/* set the labels of the key buttons again; they are looked up in the
+ * label table of the current keyboard layout */
+static void refreshKeyLabels(void *)
 {
-	config->setDefaultKeys();
-
-	/* "refresh" buttons */
 	btUp->dxkey(config->key(KEYUP));
 	btDown->dxkey(config->key(KEYDOWN));
 	btLeft->dxkey(config->key(KEYLEFT));
@@ -789,10 +1490,66 @@ static void setDefaultKeys_cb(Fl_Widget *, void *)
 	win->redraw();
 }
 
+/* set the label of a widget to a translated string, now and whenever
+ * the language is changed */
+static void bindLabel(Fl_Widget *w, ui_id id)
+{
+	boundLabel_t b = { w, id };
+	boundLabels.push_back(b);
+	w->label(ui_str(id));
+}
+
+/* relabel the window in the current language */
+static void setLabels(void)
+{
+	snprintf(playerLabel, sizeof(playerLabel), "%s %d", ui_str(UI_PLAYER), 1);
+	snprintf(jumpBackLabel, sizeof(jumpBackLabel), "%s / %s", ui_str(UI_JUMP), ui_str(UI_BACK));
+	snprintf(jumpSelectLabel, sizeof(jumpSelectLabel), "%s / %s", ui_str(UI_JUMP), ui_str(UI_SELECT));
+
+	for (size_t i = 0; i < boundLabels.size(); ++i) {
+		boundLabels.at(i).widget->label(ui_str(boundLabels.at(i).id));
+	}
+
+	conChoice->menu()[KEYBOARD_CTRLS].label(ui_str(UI_KEYBOARD));
+	conChoice->menu()[GAMEPAD_CTRLS].label(ui_str(UI_GAMEPAD));
+
+	/* the boxes on the gamepad page are as wide as their labels */
+	for (int i = 0; i < g2_gamepad->children(); ++i) {
+		PadBox *o = dynamic_cast<PadBox *>(g2_gamepad->child(i));
+
+		if (o) {
+			o->fit();
+		}
+	}
+
+	refreshKeyLabels();
+
+	if (win->but()) {
+		win->but()->label(ui_str(UI_PRESS));
+	}
+}
+
+static void setDefaultKeys_cb(Fl_Widget *, void *)
+{
+	config->setDefaultKeys();
+	refreshKeyLabels();
+}
+
+static void keyCaptured_cb(uchar dxkey, void *)
+{
+	win->captured(dxkey);
+}
+
 static void setKey_cb(Fl_Widget *o, void *)
 {
 	kbButton *b = dynamic_cast<kbButton *>(o);
-	b->label(ui_Press[lang]);  /* "Press!" */
+
+	if (!key_capture_start(keyCaptured_cb, NULL)) {
+		/* no DirectInput keyboard */
+		return;
+	}
+
+	b->label(ui_str(UI_PRESS));  /* "Press!" */
 	b->value(1);
 	win->but(b);
 	win->redraw();
@@ -800,11 +1557,17 @@ static void setKey_cb(Fl_Widget *o, void *)
 
 static void bigButton_cb(Fl_Widget *, void *)
 {
+	/* the resolution can't be saved before it's known; topology_cb()
+	 * updates the configuration */
+	topology_wait(config->reslistDisplay());
+
 	if (!config->saveConfig()) {
-		MessageBoxA(0, "Couldn't save configuration.", "Error", MB_ICONERROR|MB_OK);
+		showError("Error", "Couldn't save configuration.");
 	}
+
+	/* the game is started by main() once the launcher is released */
+	launch = true;
 	win->hide();
-	rv = launchGame();
 }
 
 static int esc_handler(int event)
@@ -815,102 +1578,69 @@ static int esc_handler(int event)
 	return 0;
 }
 
-static void startWindow(bool restart, int setX, int setY)
+/* create the widgets; the labels are in the current language */
+static void createWindow(void)
 {
 	Fl_Tabs *tabs;
 	Fl_Group *g1, *g2;
 	Fl_Button *bigButton;
-	MyChoice *resChoice;
-	std::string *devLabels;
-	Fl_Menu_Item *devItems;
-	char buf[128], bufJB[128], bufJS[128];
-
-	int sc = config->screenCount();
-	devLabels = new std::string[sc];
-	devItems = new Fl_Menu_Item[sc + 1];
-
-	if (!restart && !config->loadConfig()) {
-		config->loadDefaultConfig();
-	}
-	lang = config->language();
-
-	if (lang >= ARRLEN(langItems) - 1) {
-		lang = 0;  /* English */
-	}
-
-	Fl::add_handler(esc_handler);
-	Fl::get_system_colors();
-
-	/* use exe's icon resource to set window default icons */
-	wchar_t mod[MAX_PATH_LENGTH];
-	HICON hIconL[1] = { 0 };
-	HICON hIconS[1] = { 0 };
-	HICON *phIconL = hIconL;
-	HICON *phIconS = hIconS;
-	GetModuleFileNameW(NULL, mod, MAX_PATH_LENGTH);
-	ExtractIconExW(mod, 0, phIconL, phIconS, 1);
-	Fl_Window::default_icons(hIconL[0], hIconS[0]);
 
+	trace_begin("startWindow widgets");
 	win = new MyWindow(762, 656, "SONIC THE HEDGEHOG 4 Episode I");
 	{
 		tabs = new Fl_Tabs(32, 16, 698, 532);
 		{
 			/* "Settings" */
-			g1 = new Fl_Group(32, 36, 698, 512, ui_Settings[lang]);
+			g1 = new Fl_Group(32, 36, 698, 512);
+			bindLabel(g1, UI_SETTINGS);
 			{
-				/* Display list */
-				for (int i = 0; i < sc; ++i) {
-					_snprintf_s(buf, sizeof(buf) - 1, "Display %d", i);
-					devLabels[i] = buf;
-					devItems[i] = MENUITEM(devLabels[i].c_str());
-				}
-				devItems[sc] = {0};
-
 				/* Background image */
 				{ Fl_Box *o = new Fl_Box(-1, 9, 1, 1);
 				o->align(FL_ALIGN_BOTTOM_LEFT);
-				o->image(&back1); }
+				o->image(get_image(IMG_BACK1)); }
 
 				/* Resolution */
-				loadReslist();
-				resChoice = new MyChoice(42, 112, 328, 24, ui_Resolution[lang]);
-				resChoice->menu(resItems);
-				resChoice->value(config->resN());
+				resChoice = new MyChoice(42, 112, 328, 24);
+				bindLabel(resChoice, UI_RESOLUTION);
 				resChoice->callback(setResolution_cb);
+				showReslist();
 
 				/* Display selection */
-				{ MyChoice *o = new MyChoice(42, 64, 328, 24, ui_GraphicsDevice[lang]);
-				o->menu(devItems);
-				o->value(config->display());
-				o->callback(setDisplay_cb, reinterpret_cast<void *>(resChoice)); }
+				devChoice = new MyChoice(42, 64, 328, 24);
+				bindLabel(devChoice, UI_GRAPHICS_DEVICE);
+				devChoice->callback(setDisplay_cb);
+				showDisplays();
 				
 				/* Fullscreen */
-				{ Fl_Check_Button *o = new Fl_Check_Button(42, 150, 328, 24, ui_Fullscreen[lang]);
+				{ Fl_Check_Button *o = new Fl_Check_Button(42, 150, 328, 24);
+				bindLabel(o, UI_FULLSCREEN);
 				o->labelsize(LS);
 				o->value(config->fullscreen() == 0 ? 0 : 1);
 				o->clear_visible_focus();
 				o->callback(fullscreen_cb); }
 
 				/* Language */
-				{ MyChoice *o = new MyChoice(42, 228, 328, 24, ui_Language[lang]);
-				o->menu(langItems);
-				o->value(lang);
+				{ MyChoice *o = new MyChoice(42, 228, 328, 24);
+				bindLabel(o, UI_LANGUAGE);
+				langItems = new Fl_Menu_Item[ui_lang_count() + 1];
+				for (unsigned int i = 0; i < ui_lang_count(); ++i) {
+					langItems[i] = MENUITEM(ui_lang_name(i));
+				}
+				langItems[ui_lang_count()] = { 0 };
+				o->view(langItems);
+				o->value(ui_lang());
 				o->callback(setLang_cb); }
 			}
 			g1->end();
 			g1->labelsize(LS);
 
-			_snprintf_s(buf, sizeof(buf) - 1, "%s %d", ui_Player[lang], 1);
-			_snprintf_s(bufJB, sizeof(bufJB) - 1, "%s / %s", ui_Jump[lang], ui_Back[lang]);
-			_snprintf_s(bufJS, sizeof(bufJS) - 1, "%s / %s", ui_Jump[lang], ui_Select[lang]);
-
 			/* "Player 1" */
 			g2 = new Fl_Group(32, 36, 698, 512);
-			g2->label(buf);
+			g2->label(playerLabel);
 			{
 				const Fl_Menu_Item conItems[] = {
-					MENUITEM(ui_Keyboard[lang]),
-					MENUITEM(ui_Gamepad[lang]),
+					MENUITEM(ui_str(UI_KEYBOARD)),
+					MENUITEM(ui_str(UI_GAMEPAD)),
 					{0}
 				};
 
@@ -922,13 +1652,15 @@ static void startWindow(bool restart, int setX, int setY)
 				g2_keyboard = new Fl_Group(32, 36, 698, 512);
 				{
 					/* Reset settings */
-					{ Fl_Button *o = new Fl_Button(42, 102, 328, 24, ui_ResetToDefault[lang]);
+					{ Fl_Button *o = new Fl_Button(42, 102, 328, 24);
+					bindLabel(o, UI_RESET_TO_DEFAULT);
 					o->labelsize(LS);
 					o->clear_visible_focus();
 					o->callback(setDefaultKeys_cb); }
 
 					/* "Movement" frame */
-					{ Fl_Box *o = new Fl_Box(59, 192, 312, 277, ui_Movement[lang]);
+					{ Fl_Box *o = new Fl_Box(59, 192, 312, 277);
+					bindLabel(o, UI_MOVEMENT);
 					o->labelsize(LS);
 					o->align(FL_ALIGN_TOP_LEFT);
 					o->box(FL_ENGRAVED_FRAME); }
@@ -938,43 +1670,48 @@ static void startWindow(bool restart, int setX, int setY)
 					btUp->config(config);
 					btUp->keytype(KEYUP);
 					btUp->callback(setKey_cb);
-					{ Fl_Box *o = new Fl_Box(174, 203, 89, 38, ui_Up[lang]);
+					{ Fl_Box *o = new Fl_Box(174, 203, 89, 38);
+					bindLabel(o, UI_UP);
 					o->labelsize(LS); }
 					{ Fl_Box *o = new Fl_Box(216, 299, 1, 1);
-					o->image(&arrow_04); }
+					o->image(get_image(IMG_ARROW_04)); }
 
 					/* Left */
 					btLeft = new kbButton(70, 311, 89, 38);
 					btLeft->config(config);
 					btLeft->keytype(KEYLEFT);
 					btLeft->callback(setKey_cb);
-					{ Fl_Box *o = new Fl_Box(70, 273, 89, 38, ui_Left[lang]);
+					{ Fl_Box *o = new Fl_Box(70, 273, 89, 38);
+					bindLabel(o, UI_LEFT);
 					o->labelsize(LS); }
 					{ Fl_Box *o = new Fl_Box(179, 330, 1, 1);
-					o->image(&arrow_01); }
+					o->image(get_image(IMG_ARROW_01)); }
 
 					/* Right */
 					btRight = new kbButton(274, 311, 89, 38);
 					btRight->config(config);
 					btRight->keytype(KEYRIGHT);
 					btRight->callback(setKey_cb);
-					{ Fl_Box *o = new Fl_Box(274, 273, 89, 38, ui_Right[lang]);
+					{ Fl_Box *o = new Fl_Box(274, 273, 89, 38);
+					bindLabel(o, UI_RIGHT);
 					o->labelsize(LS); }
 					{ Fl_Box *o = new Fl_Box(254, 330, 1, 1);
-					o->image(&arrow_02); }
+					o->image(get_image(IMG_ARROW_02)); }
 
 					/* Down */
 					btDown = new kbButton(174, 381, 89, 38);
 					btDown->config(config);
 					btDown->keytype(KEYDOWN);
 					btDown->callback(setKey_cb);
-					{ Fl_Box *o = new Fl_Box(174, 423, 89, 38, ui_Down[lang]);
+					{ Fl_Box *o = new Fl_Box(174, 423, 89, 38);
+					bindLabel(o, UI_DOWN);
 					o->labelsize(LS); }
 					{ Fl_Box *o = new Fl_Box(216, 365, 1, 1);
-					o->image(&arrow_03); }
+					o->image(get_image(IMG_ARROW_03)); }
 
 					/* "Action" frame */
-					{ Fl_Box *o = new Fl_Box(407, 192, 294, 277, ui_Action[lang]);
+					{ Fl_Box *o = new Fl_Box(407, 192, 294, 277);
+					bindLabel(o, UI_ACTION);
 					o->labelsize(LS);
 					o->align(FL_ALIGN_TOP_LEFT);
 					o->box(FL_ENGRAVED_FRAME); }
@@ -984,55 +1721,58 @@ static void startWindow(bool restart, int setX, int setY)
 					btX->config(config);
 					btX->keytype(KEYX);
 					btX->callback(setKey_cb);
-					{ Fl_Box *o = new Fl_Box(452, 223, 1, 1, ui_ScoreAttack[lang]);
+					{ Fl_Box *o = new Fl_Box(452, 223, 1, 1);
+					bindLabel(o, UI_SCORE_ATTACK);
 					o->labelsize(LS);
 					o->align(FL_ALIGN_RIGHT); }
 					{ Fl_Box *o = new Fl_Box(432, 223, 1, 1);
-					o->image(&button_04); }
+					o->image(get_image(IMG_BUTTON_04)); }
 					
 					/* Super Sonic */
 					btY = new kbButton(432, 329, 89, 38);
 					btY->config(config);
 					btY->keytype(KEYY);
 					btY->callback(setKey_cb);
-					{ Fl_Box *o = new Fl_Box(452, 305, 1, 1, ui_SuperSonic[lang]);
+					{ Fl_Box *o = new Fl_Box(452, 305, 1, 1);
+					bindLabel(o, UI_SUPER_SONIC);
 					o->labelsize(LS);
 					o->align(FL_ALIGN_RIGHT); }
 					{ Fl_Box *o = new Fl_Box(432, 305, 1, 1);
-					o->image(&button_01); }
+					o->image(get_image(IMG_BUTTON_01)); }
 
 					/* Jump / Back */
 					btB = new kbButton(432, 411, 89, 38);
 					btB->config(config);
 					btB->keytype(KEYB);
 					btB->callback(setKey_cb);
-					{ Fl_Box *o = new Fl_Box(452, 387, 1, 1, bufJB);
+					{ Fl_Box *o = new Fl_Box(452, 387, 1, 1, jumpBackLabel);
 					o->labelsize(LS);
 					o->align(FL_ALIGN_RIGHT); }
 					{ Fl_Box *o = new Fl_Box(432, 387, 1, 1);
-					o->image(&button_02); }
+					o->image(get_image(IMG_BUTTON_02)); }
 
 					/* Start */
 					btStart = new kbButton(590, 329, 89, 38);
 					btStart->config(config);
 					btStart->keytype(KEYSTART);
 					btStart->callback(setKey_cb);
-					{ Fl_Box *o = new Fl_Box(590, 305, 1, 1, ui_Start[lang]);
+					{ Fl_Box *o = new Fl_Box(590, 305, 1, 1);
+					bindLabel(o, UI_START);
 					o->labelsize(LS);
 					o->align(FL_ALIGN_RIGHT); }
 					{ Fl_Box *o = new Fl_Box(570, 305, 1, 1);
-					o->image(&button_05); }
+					o->image(get_image(IMG_BUTTON_05)); }
 
 					/* Jump / Select */
 					btA = new kbButton(590, 411, 89, 38);
 					btA->config(config);
 					btA->keytype(KEYA);
 					btA->callback(setKey_cb);
-					{ Fl_Box *o = new Fl_Box(590, 387, 1, 1, bufJS);
+					{ Fl_Box *o = new Fl_Box(590, 387, 1, 1, jumpSelectLabel);
 					o->labelsize(LS);
 					o->align(FL_ALIGN_RIGHT); }
 					{ Fl_Box *o = new Fl_Box(570, 387, 1, 1);
-					o->image(&button_03); }
+					o->image(get_image(IMG_BUTTON_03)); }
 				}
 				g2_keyboard->end();
 
@@ -1040,7 +1780,8 @@ static void startWindow(bool restart, int setX, int setY)
 				g2_gamepad = new Fl_Group(32, 36, 698, 512);
 				{
 					/* Vibrate */
-					{ Fl_Check_Button *o = new Fl_Check_Button(42, 102, 328, 24, ui_Vibrate[lang]);
+					{ Fl_Check_Button *o = new Fl_Check_Button(42, 102, 328, 24);
+					bindLabel(o, UI_VIBRATE);
 					o->labelsize(LS);
 					o->value(config->vibra() == 0 ? 0 : 1);
 					o->clear_visible_focus();
@@ -1048,28 +1789,32 @@ static void startWindow(bool restart, int setX, int setY)
 
 					/* Gamepad overlay image */
 					{ Fl_Box *o = new Fl_Box(368, 298, 1, 1);
-					o->image(&pad_controls_v02); }
-
-					new PadBox(144, 207, 18, ui_Back[lang], FL_ALIGN_RIGHT);
-					new PadBox(144, 240, 18, ui_Up[lang], FL_ALIGN_RIGHT);
-					new PadBox(144, 268, 18, ui_Right[lang], FL_ALIGN_RIGHT);
-					new PadBox(144, 295, 18, ui_Left[lang], FL_ALIGN_RIGHT);
-					new PadBox(144, 322, 18, ui_Down[lang], FL_ALIGN_RIGHT);
-					new PadBox(542, 207, 18, ui_Start[lang]);
-					new PadBox(542, 234, 18, ui_SuperSonic[lang]);
-					new PadBox(542, 258, 18, ui_ScoreAttack[lang]);
-					new PadBox(542, 302, 18, bufJB);
-					new PadBox(542, 328, 18, bufJS);
+					o->image(get_image(IMG_PAD_CONTROLS_V02)); }
+
+					bindLabel(new PadBox(144, 207, 18, NULL, FL_ALIGN_RIGHT), UI_BACK);
+					bindLabel(new PadBox(144, 240, 18, NULL, FL_ALIGN_RIGHT), UI_UP);
+					bindLabel(new PadBox(144, 268, 18, NULL, FL_ALIGN_RIGHT), UI_RIGHT);
+					bindLabel(new PadBox(144, 295, 18, NULL, FL_ALIGN_RIGHT), UI_LEFT);
+					bindLabel(new PadBox(144, 322, 18, NULL, FL_ALIGN_RIGHT), UI_DOWN);
+					bindLabel(new PadBox(542, 207, 18, NULL), UI_START);
+					bindLabel(new PadBox(542, 234, 18, NULL), UI_SUPER_SONIC);
+					bindLabel(new PadBox(542, 258, 18, NULL), UI_SCORE_ATTACK);
+					new PadBox(542, 302, 18, jumpBackLabel);
+					new PadBox(542, 328, 18, jumpSelectLabel);
+
+					/* Live controller state */
+					new PadView(42, 432, 678, 108);
 				}
 				g2_gamepad->end();
 
 				/* Select keyboard/controller */
-				{ MyChoice *o = new MyChoice(42, 64, 328, 24, ui_ControllerSelection[lang]);
-				o->menu(conItems);
-				o->value(config->controls());
-				o->callback(setController_cb, reinterpret_cast<void *>(bg));
+				conChoice = new MyChoice(42, 64, 328, 24);
+				bindLabel(conChoice, UI_CONTROLLER_SELECTION);
+				conChoice->menu(conItems);
+				conChoice->value(config->controls());
+				conChoice->callback(setController_cb, reinterpret_cast<void *>(bg));
 				/* Run callback once */
-				setController_cb(o, reinterpret_cast<void *>(bg)); }
+				setController_cb(conChoice, reinterpret_cast<void *>(bg));
 			}
 			g2->end();
 			g2->labelsize(LS);
@@ -1078,7 +1823,8 @@ static void startWindow(bool restart, int setX, int setY)
 		tabs->clear_visible_focus();
 
 		/* launch button */
-		bigButton = new Fl_Button(62, 564, 642, 68, ui_SaveSettings[lang]);
+		bigButton = new Fl_Button(62, 564, 642, 68);
+		bindLabel(bigButton, UI_SAVE_SETTINGS);
 		bigButton->labelsize(16);
 		bigButton->clear_visible_focus();
 		bigButton->callback(bigButton_cb);
@@ -1090,51 +1836,220 @@ static void startWindow(bool restart, int setX, int setY)
 	}
 	win->end();
 
-	if (restart) {
-		/* window restarted, restore old positions */
-		win->position(setX, setY);
-	} else {
-		/* new window, position in center */
-		win->position((Fl::w() - 762) / 2, (Fl::h() - 656) / 2);
+	/* composed labels and widths */
+	setLabels();
+	trace_end("startWindow widgets");
+}
+
+static void startWindow(void)
+{
+	if (!config->loadConfig()) {
+		config->loadDefaultConfig();
 	}
+	setLanguage();
+
+	Fl::add_handler(esc_handler);
+	Fl::get_system_colors();
+
+#ifdef _WIN32
+	/* use exe's icon resource to set window default icons */
+	wchar_t mod[MAX_PATH_LENGTH];
+	HICON hIconL[1] = { 0 };
+	HICON hIconS[1] = { 0 };
+	HICON *phIconL = hIconL;
+	HICON *phIconS = hIconS;
+	GetModuleFileNameW(NULL, mod, MAX_PATH_LENGTH);
+	trace_begin("ExtractIconExW");
+	ExtractIconExW(mod, 0, phIconL, phIconS, 1);
+	trace_end("ExtractIconExW");
+	Fl_Window::default_icons(hIconL[0], hIconS[0]);
+#endif
+
+	createWindow();
+
+	win->position((Fl::w() - 762) / 2, (Fl::h() - 656) / 2);
+	trace_begin("first paint");
 	win->show();
 
+	/* follow monitors being plugged in or removed */
+	topology_watch(fl_xid(win));
+	key_capture_window(fl_xid(win));
+	pad_monitor_watch(fl_xid(win));
+	key_labels_watch(fl_xid(win), refreshKeyLabels, NULL);
+
+	/* decode the images of the "Player 1" tab in the background;
+	 * the art of the other controller type is decoded on demand */
+	if (config->controls() == GAMEPAD_CTRLS) {
+		const image_id ids[] = { IMG_BACK2, IMG_PAD_CONTROLS_V02 };
+		image_predecode(ids, ARRLEN(ids));
+	} else {
+		const image_id ids[] = {
+			IMG_BACK3, IMG_ARROW_01, IMG_ARROW_02, IMG_ARROW_03, IMG_ARROW_04,
+			IMG_BUTTON_01, IMG_BUTTON_02, IMG_BUTTON_03, IMG_BUTTON_04, IMG_BUTTON_05
+		};
+		image_predecode(ids, ARRLEN(ids));
+	}
+
 	Fl::run();
+}
+
+/* free the window, the decoded images, DirectInput and everything else the
+ * launcher doesn't need while the game runs */
+static void releaseLauncher(void)
+{
+	trace_begin("releaseLauncher");
+
+	delete win;
+	win = NULL;
 
+	delete[] resItems;
 	delete[] devItems;
-	delete[] devLabels;
+	delete[] langItems;
+	resItems = devItems = langItems = NULL;
+	boundLabels.clear();
+
+	image_release_all();
+	key_capture_free();
+	key_labels_clear();
+	text_fit_clear();
+	pad_monitor_free();
+	topology_free();
+	ui_lang_packs_free();
+	cache_reset();
+
+	delete config;
+	config = NULL;
+
+	trace_end("releaseLauncher");
+}
+
+#ifndef _WIN32
+/* take -GameDir and the command after "--" from the arguments */
+static bool parseGameCommand(int argc, char *argv[])
+{
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--") == 0) {
+			gameCommand.assign(argv + i + 1, argv + argc);
+			break;
+		} else if (stricmp(argv[i], "-GameDir") == 0) {
+			if (++i == argc) {
+				showError("Error", "-GameDir needs a directory");
+				return false;
+			}
+			gameDir = argv[i];
+		}
+	}
+
+	/* the last .exe is the one Proton runs; anything before it is Proton
+	 * itself or a wrapper like the Steam runtime */
+	for (size_t i = 0; i < gameCommand.size(); ++i) {
+		size_t len = strlen(gameCommand.at(i));
+
+		if (len > 4 && strcasecmp(gameCommand.at(i) + len - 4, ".exe") == 0) {
+			gameExe = static_cast<int>(i);
+		}
+	}
+
+	return true;
 }
+#endif
 
 int main(int argc, char *argv[])
 {
-	if (!getModuleRootDir()) {
-		MessageBoxA(0, "Failed calling GetModuleFileName()", "Error", MB_ICONERROR|MB_OK);
+	trace_instant("main");
+	text_fit_source(text_fit_fltk());
+
+#ifndef _WIN32
+	if (!parseGameCommand(argc, argv)) {
 		return 1;
 	}
+#endif
 
-	config = new configuration(confFile);
+	if (!getModuleRootDir()) {
+#ifdef _WIN32
+		showError("Error", "Failed calling GetModuleFileName()");
+#else
+		showError("Error", "Couldn't find the game directory, use -GameDir");
+#endif
+		return 1;
+	}
 
 	if (argc > 0) {
 		for (int i = 0; i < argc; ++i) {
 			if (stricmp(argv[i], "-QuickBoot") == 0) {
-				if (!config->loadConfig()) {
-					config->loadDefaultConfig();
-					config->saveConfig();
-				}
-				delete config;
-				return launchGame();
+				return quickBoot();
+			} else if (stricmp(argv[i], "-QuickBootTime") == 0) {
+				/* like -QuickBoot, but print how long it took to get to CreateProcess() */
+				quickBootTime = true;
+				return quickBoot();
+			} else if (stricmp(argv[i], "-TraceExit") == 0) {
+				/* close the window right after it was painted the first time */
+				traceExit = true;
+			} else if (stricmp(argv[i], "-SessionMemory") == 0) {
+				/* print the memory the launcher keeps while the game runs */
+				sessionMemory = true;
+			} else if (stricmp(argv[i], "-SaveExit") == 0) {
+				/* save the configuration after the first paint and exit
+				 * without launching the game */
+				saveExit = true;
+			} else if (stricmp(argv[i], "-NoCache") == 0) {
+				/* neither use nor update the startup cache */
+				cache_disable();
+			} else if (stricmp(argv[i], "-NoPrefetch") == 0) {
+				/* don't read the game files in the background */
+				prefetch_disable();
+			} else if (stricmp(argv[i], "-PrefetchStats") == 0) {
+				/* print the bytes prefetched and when the game was ready */
+				prefetchStats = true;
+#ifdef _WIN32
+			} else if (stricmp(argv[i], "-CacheBench") == 0) {
+				return cacheBench();
+			} else if (stricmp(argv[i], "-KeyBench") == 0) {
+				return keyBench();
+			} else if (stricmp(argv[i], "-FitCheck") == 0) {
+				return fitCheck();
+			} else if (stricmp(argv[i], "-LangCycle") == 0) {
+				return langCycle();
+#endif
+			} else if (strcmp(argv[i], "--") == 0) {
+				/* the game command, see parseGameCommand() */
+				break;
 			}
 		}
 	}
 
-	directinput = new DirectInput();
+	/* the disk is idle while the settings are shown */
+	prefetch_start(moduleRootDir);
+
+	cache_load(cacheFile);
+
+	trace_begin("configuration");
+	config = new configuration(confFile);
+	trace_end("configuration");
+
+	/* the window is shown while the display modes are being enumerated */
+	topology_callback(topology_cb, NULL);
+	topology_init(true);
+	config->screenCount(topology_count());
 
 	/* needs to be initialized before we launch our window */
-	directinput->init();
+	trace_begin("key_capture_init");
+	key_capture_init();
+	trace_end("key_capture_init");
 
-	startWindow(false, 0, 0);
+	startWindow();
 
-	delete directinput;
-	delete config;
+	prefetch_stop(launch);
+	image_predecode_cancel();
+	cache_save();
+	trace_memory();
+
+	releaseLauncher();
+
+	if (launch) {
+		return launchGame();
+	}
+
+	trace_write();
 	return rv;
 }
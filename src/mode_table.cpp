@@ -0,0 +1,111 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <stdio.h>
+
+#include "mode_table.hpp"
+
+
+void modeTable::clear()
+{
+	_modes.clear();
+	_index.clear();
+	_labels.clear();
+}
+
+bool modeTable::add(uint16_t w, uint16_t h)
+{
+	uint32_t key = MODE_KEY(w, h);
+
+	if (!_index.emplace(key, _modes.size()).second) {
+		return false;
+	}
+
+	_modes.push_back(key);
+	_labels.clear();
+	return true;
+}
+
+static bool compareModes(uint32_t a, uint32_t b)
+{
+	uint32_t areaA = static_cast<uint32_t>(MODE_W(a)) * MODE_H(a);
+	uint32_t areaB = static_cast<uint32_t>(MODE_W(b)) * MODE_H(b);
+
+	if (areaA != areaB) {
+		return areaA > areaB;
+	}
+
+	/* the keys are unique, so this makes the order deterministic */
+	return a > b;
+}
+
+void modeTable::sort()
+{
+	std::sort(_modes.begin(), _modes.end(), compareModes);
+
+	for (size_t i = 0; i < _modes.size(); ++i) {
+		_index[_modes[i]] = i;
+	}
+	_labels.clear();
+}
+
+void modeTable::fill(modeSource &src)
+{
+	uint16_t w, h;
+
+	clear();
+
+	for (int i = 0; src.mode(i, w, h); ++i) {
+		add(w, h);
+	}
+
+	sort();
+}
+
+int modeTable::find(uint16_t w, uint16_t h) const
+{
+	auto it = _index.find(MODE_KEY(w, h));
+	return (it == _index.end()) ? -1 : static_cast<int>(it->second);
+}
+
+const char *modeTable::label(size_t i)
+{
+	if (i >= _modes.size()) {
+		return "";
+	}
+
+	/* a label that wasn't formatted yet starts with a null byte */
+	if (_labels.size() != _modes.size() * MODE_LABEL_SIZE) {
+		_labels.assign(_modes.size() * MODE_LABEL_SIZE, 0);
+	}
+
+	char *p = &_labels[i * MODE_LABEL_SIZE];
+
+	if (p[0] == 0) {
+		snprintf(p, MODE_LABEL_SIZE, "%ux%u", MODE_W(_modes[i]), MODE_H(_modes[i]));
+	}
+
+	return p;
+}
@@ -0,0 +1,97 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Table of display modes.
+ *
+ * Modes are stored as packed (w<<16|h) keys and deduplicated while they are
+ * added.  sort() brings them into a deterministic order (largest area first,
+ * wider first on a tie).  Looking up the index of a mode is O(1) and labels
+ * are only formatted when they are requested.
+ *
+ * The modes come from a modeSource, so the table doesn't depend on the
+ * display API.
+ */
+
+#ifndef MODE_TABLE_HPP
+#define MODE_TABLE_HPP
+
+#include <unordered_map>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MODE_KEY(w, h)  (static_cast<uint32_t>(w) << 16 | static_cast<uint32_t>(h))
+#define MODE_W(key)     static_cast<uint16_t>((key) >> 16)
+#define MODE_H(key)     static_cast<uint16_t>((key) & 0xFFFF)
+
+/* "65535x65535" */
+#define MODE_LABEL_SIZE  12
+
+
+/* lists the modes of a display, e.g. with EnumDisplaySettings();
+ * the same size may be listed any number of times */
+class modeSource
+{
+public:
+	virtual ~modeSource() {}
+
+	/* size of mode number `i'; returns false after the last mode */
+	virtual bool mode(int i, uint16_t &w, uint16_t &h) = 0;
+};
+
+class modeTable
+{
+private:
+	std::vector<uint32_t> _modes;
+	std::unordered_map<uint32_t, size_t> _index;
+	std::vector<char> _labels;
+
+public:
+	void clear();
+
+	/* returns false if the mode is already in the table */
+	bool add(uint16_t w, uint16_t h);
+
+	/* call after all modes were added; invalidates indices and labels */
+	void sort();
+
+	/* replace the table with the sorted modes of a source */
+	void fill(modeSource &src);
+
+	size_t size() const { return _modes.size(); }
+	bool empty() const { return _modes.empty(); }
+
+	uint32_t at(size_t i) const { return _modes.at(i); }
+	uint16_t w(size_t i) const { return MODE_W(_modes.at(i)); }
+	uint16_t h(size_t i) const { return MODE_H(_modes.at(i)); }
+
+	/* index of a mode or -1 */
+	int find(uint16_t w, uint16_t h) const;
+
+	/* "WxH"; the pointer stays valid until the table is modified */
+	const char *label(size_t i);
+};
+
+#endif  /* MODE_TABLE_HPP */
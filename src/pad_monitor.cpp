@@ -0,0 +1,364 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <windows.h>
+#include <dbt.h>
+#include <mmsystem.h>
+#include <process.h>
+#include <xinput.h>
+#include <math.h>
+#include <string.h>
+
+#include <FL/Fl.H>
+
+#include "pad_monitor.hpp"
+#include "window_hooks.hpp"
+
+#define POLL_MS    1    /* 1 kHz */
+#define NOTIFY_MS  8.0  /* the view doesn't need more than ~120 updates per second */
+
+static_assert(PAD_DPAD_UP == XINPUT_GAMEPAD_DPAD_UP && PAD_DPAD_DOWN == XINPUT_GAMEPAD_DPAD_DOWN &&
+	PAD_DPAD_LEFT == XINPUT_GAMEPAD_DPAD_LEFT && PAD_DPAD_RIGHT == XINPUT_GAMEPAD_DPAD_RIGHT &&
+	PAD_START == XINPUT_GAMEPAD_START && PAD_BACK == XINPUT_GAMEPAD_BACK &&
+	PAD_LEFT_THUMB == XINPUT_GAMEPAD_LEFT_THUMB && PAD_RIGHT_THUMB == XINPUT_GAMEPAD_RIGHT_THUMB &&
+	PAD_LEFT_SHOULDER == XINPUT_GAMEPAD_LEFT_SHOULDER && PAD_RIGHT_SHOULDER == XINPUT_GAMEPAD_RIGHT_SHOULDER &&
+	PAD_A == XINPUT_GAMEPAD_A && PAD_B == XINPUT_GAMEPAD_B && PAD_X == XINPUT_GAMEPAD_X && PAD_Y == XINPUT_GAMEPAD_Y,
+	"button bits don't match xinput.h");
+
+
+typedef DWORD (WINAPI *XInputGetState_t)(DWORD, XINPUT_STATE *);
+
+/* only used by the worker thread */
+typedef struct {
+	bool connected;
+	DWORD packet;
+	double last;      /* time of the last change */
+	uint32_t n;       /* intervals */
+	double mean, m2;  /* Welford's running variance */
+} track_t;
+
+static HMODULE xinput = NULL;
+static XInputGetState_t getState = NULL;
+
+static CRITICAL_SECTION lock;
+static pad_status_t pads[PAD_MONITOR_PADS];  /* guarded by lock */
+static track_t track[PAD_MONITOR_PADS];
+
+static HANDLE thread = NULL;
+static HANDLE quitEvent = NULL;
+static HANDLE wakeEvent = NULL;
+static volatile LONG running = 0;
+static volatile LONG restart = 0;
+static volatile LONG redetect = 0;
+static volatile LONG queued = 0;
+static volatile LONG rate = 0;
+
+static void (*callback)(void *) = NULL;
+static void *callbackData = NULL;
+
+
+double pad_monitor_time(void)
+{
+	static LARGE_INTEGER freq = { 0 };
+	LARGE_INTEGER now;
+
+	if (freq.QuadPart == 0) {
+		QueryPerformanceFrequency(&freq);
+	}
+	QueryPerformanceCounter(&now);
+
+	return static_cast<double>(now.QuadPart) * 1000.0 / freq.QuadPart;
+}
+
+static bool load_xinput(void)
+{
+	const char *names[] = { "xinput1_4.dll", "xinput1_3.dll", "xinput9_1_0.dll" };
+
+	if (getState) {
+		return true;
+	}
+
+	for (size_t i = 0; i < sizeof(names) / sizeof(*names) && !xinput; ++i) {
+		xinput = LoadLibraryA(names[i]);
+	}
+
+	if (!xinput) {
+		return false;
+	}
+
+	getState = reinterpret_cast<XInputGetState_t>(GetProcAddress(xinput, "XInputGetState"));
+
+	if (!getState) {
+		FreeLibrary(xinput);
+		xinput = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+/* main thread */
+static void notify_cb(void *)
+{
+	InterlockedExchange(&queued, 0);
+
+	if (callback && running) {
+		callback(callbackData);
+	}
+}
+
+static void record_change(DWORD pad, const XINPUT_STATE *state, double now)
+{
+	track_t *t = &track[pad];
+	int bucket = 0;
+
+	if (t->last > 0) {
+		double interval = now - t->last;
+		double delta = interval - t->mean;
+
+		t->n++;
+		t->mean += delta / t->n;
+		t->m2 += delta * (interval - t->mean);
+
+		for (double limit = 1.0; interval >= limit && bucket < PAD_MONITOR_BUCKETS - 1; limit *= 2) {
+			bucket++;
+		}
+	}
+	t->last = now;
+
+	EnterCriticalSection(&lock);
+	pad_status_t *s = &pads[pad];
+	s->buttons = state->Gamepad.wButtons;
+	s->leftTrigger = state->Gamepad.bLeftTrigger;
+	s->rightTrigger = state->Gamepad.bRightTrigger;
+	s->thumbLX = state->Gamepad.sThumbLX;
+	s->thumbLY = state->Gamepad.sThumbLY;
+	s->thumbRX = state->Gamepad.sThumbRX;
+	s->thumbRY = state->Gamepad.sThumbRY;
+	s->changes++;
+	s->changeTime = now;
+
+	if (t->n > 0) {
+		s->intervalMean = t->mean;
+		s->intervalJitter = sqrt(t->m2 / t->n);
+		s->histogram[bucket]++;
+	}
+	LeaveCriticalSection(&lock);
+}
+
+/* returns true if anything changed */
+static bool poll(void)
+{
+	XINPUT_STATE state;
+	bool changed = false;
+	bool all = (InterlockedExchange(&redetect, 0) != 0);
+	double now = pad_monitor_time();
+
+	if (InterlockedExchange(&restart, 0) != 0) {
+		memset(track, 0, sizeof(track));
+		EnterCriticalSection(&lock);
+		memset(pads, 0, sizeof(pads));
+		LeaveCriticalSection(&lock);
+		all = true;
+	}
+
+	for (DWORD i = 0; i < PAD_MONITOR_PADS; ++i) {
+		track_t *t = &track[i];
+
+		if (!all && !t->connected) {
+			continue;
+		}
+
+		memset(&state, 0, sizeof(state));
+		bool connected = (getState(i, &state) == ERROR_SUCCESS);
+
+		if (connected != t->connected) {
+			memset(t, 0, sizeof(*t));
+			t->connected = connected;
+			t->packet = state.dwPacketNumber - 1;  /* show the first state */
+
+			EnterCriticalSection(&lock);
+			memset(&pads[i], 0, sizeof(pads[i]));
+			pads[i].connected = connected;
+			LeaveCriticalSection(&lock);
+			changed = true;
+		}
+
+		if (connected && state.dwPacketNumber != t->packet) {
+			t->packet = state.dwPacketNumber;
+			record_change(i, &state, now);
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+static unsigned __stdcall poll_thread(void *)
+{
+	HANDLE events[2] = { quitEvent, wakeEvent };
+	double lastNotify = 0, rateStart = 0;
+	bool dirty = false;
+	LONG polls = 0;
+
+	for (;;) {
+		if (!running) {
+			/* the view is hidden */
+			if (WaitForMultipleObjects(2, events, FALSE, INFINITE) == WAIT_OBJECT_0) {
+				break;
+			}
+			rateStart = pad_monitor_time();
+			polls = 0;
+			continue;
+		}
+
+		if (poll()) {
+			dirty = true;
+		}
+		polls++;
+
+		double now = pad_monitor_time();
+
+		if (now - rateStart >= 1000.0) {
+			InterlockedExchange(&rate, static_cast<LONG>(polls * 1000.0 / (now - rateStart) + 0.5));
+			rateStart = now;
+			polls = 0;
+		}
+
+		if (dirty && now - lastNotify >= NOTIFY_MS && InterlockedExchange(&queued, 1) == 0) {
+			Fl::awake(notify_cb, NULL);
+			lastNotify = now;
+			dirty = false;
+		}
+
+		if (WaitForSingleObject(quitEvent, POLL_MS) == WAIT_OBJECT_0) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+bool pad_monitor_start(void (*cb)(void *), void *data)
+{
+	if (!load_xinput()) {
+		return false;
+	}
+
+	if (!thread) {
+		InitializeCriticalSection(&lock);
+		quitEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+		wakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+
+		if (quitEvent && wakeEvent) {
+			thread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, poll_thread, NULL, 0, NULL));
+		}
+
+		if (!thread) {
+			DeleteCriticalSection(&lock);
+			pad_monitor_free();
+			return false;
+		}
+	}
+
+	callback = cb;
+	callbackData = data;
+
+	if (InterlockedExchange(&running, 1) == 0) {
+		/* Sleep() and timeouts have a 15.6 ms resolution otherwise */
+		timeBeginPeriod(POLL_MS);
+		InterlockedExchange(&restart, 1);
+		InterlockedExchange(&rate, 0);
+		SetEvent(wakeEvent);
+	}
+
+	return true;
+}
+
+void pad_monitor_stop(void)
+{
+	if (InterlockedExchange(&running, 0) != 0) {
+		timeEndPeriod(POLL_MS);
+	}
+}
+
+static void pad_hook(UINT msg, WPARAM wParam, LPARAM)
+{
+	if (msg == WM_DEVICECHANGE && wParam == DBT_DEVNODES_CHANGED) {
+		InterlockedExchange(&redetect, 1);
+	}
+}
+
+void pad_monitor_watch(HWND hwnd)
+{
+	window_hook_add(pad_hook);
+	window_hooks_attach(hwnd);
+}
+
+bool pad_monitor_status(int pad, pad_status_t *status)
+{
+	if (!thread || pad < 0 || pad >= PAD_MONITOR_PADS) {
+		return false;
+	}
+
+	EnterCriticalSection(&lock);
+	*status = pads[pad];
+	LeaveCriticalSection(&lock);
+
+	return status->connected;
+}
+
+int pad_monitor_rate(void)
+{
+	return static_cast<int>(rate);
+}
+
+void pad_monitor_free(void)
+{
+	pad_monitor_stop();
+
+	if (thread) {
+		SetEvent(quitEvent);
+		WaitForSingleObject(thread, INFINITE);
+		CloseHandle(thread);
+		thread = NULL;
+		DeleteCriticalSection(&lock);
+	}
+
+	if (quitEvent) {
+		CloseHandle(quitEvent);
+		quitEvent = NULL;
+	}
+
+	if (wakeEvent) {
+		CloseHandle(wakeEvent);
+		wakeEvent = NULL;
+	}
+
+	if (xinput) {
+		FreeLibrary(xinput);
+		xinput = NULL;
+		getState = NULL;
+	}
+}
@@ -0,0 +1,108 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Live gamepad diagnostics.
+ *
+ * A worker thread polls the XInput controllers at up to 1 kHz while the
+ * gamepad view is visible and sleeps on an event otherwise.  XInput only
+ * bumps the packet number when the state of a controller changed, so the
+ * interval between two changes is what the statistics are built from:
+ * mean, jitter (standard deviation) and a histogram.  The time at which a
+ * change was polled is kept, so the view can compute the poll-to-paint
+ * latency.
+ *
+ * Polling a slot without a controller is slow, so only connected slots are
+ * polled; all slots are checked again when the monitor is started and on
+ * WM_DEVICECHANGE.
+ *
+ * XInput is loaded at runtime, without it the monitor reports no controllers.
+ * Fl::lock() must have been called before.
+ */
+
+#ifndef PAD_MONITOR_HPP
+#define PAD_MONITOR_HPP
+
+#include <stdint.h>
+
+#include "native_window.hpp"
+
+#define PAD_MONITOR_PADS     4
+#define PAD_MONITOR_BUCKETS  8  /* < 1, 2, 4, ... 64 ms, >= 64 ms */
+
+/* the bits of pad_status_t::buttons (XINPUT_GAMEPAD_*) */
+#define PAD_DPAD_UP         0x0001
+#define PAD_DPAD_DOWN       0x0002
+#define PAD_DPAD_LEFT       0x0004
+#define PAD_DPAD_RIGHT      0x0008
+#define PAD_START           0x0010
+#define PAD_BACK            0x0020
+#define PAD_LEFT_THUMB      0x0040
+#define PAD_RIGHT_THUMB     0x0080
+#define PAD_LEFT_SHOULDER   0x0100
+#define PAD_RIGHT_SHOULDER  0x0200
+#define PAD_A               0x1000
+#define PAD_B               0x2000
+#define PAD_X               0x4000
+#define PAD_Y               0x8000
+
+
+typedef struct {
+	bool connected;
+
+	/* XINPUT_GAMEPAD */
+	uint16_t buttons;
+	uint8_t leftTrigger, rightTrigger;
+	int16_t thumbLX, thumbLY, thumbRX, thumbRY;
+
+	uint32_t changes;      /* state changes since the monitor was started */
+	double changeTime;     /* when the last change was polled, see pad_monitor_time() */
+	double intervalMean;   /* ms between two changes */
+	double intervalJitter; /* standard deviation in ms */
+	uint32_t histogram[PAD_MONITOR_BUCKETS];
+} pad_status_t;
+
+/* start polling; `cb' is called on the main thread after changes were seen,
+ * at most about every 8 ms */
+bool pad_monitor_start(void (*cb)(void *), void *data);
+
+/* stop polling; the thread stays idle until the next start */
+void pad_monitor_stop(void);
+
+/* check all slots for connected controllers again on WM_DEVICECHANGE */
+void pad_monitor_watch(nativeWindow hwnd);
+
+/* copy the state of controller `pad'; returns false if it isn't connected */
+bool pad_monitor_status(int pad, pad_status_t *status);
+
+/* polls per second over the last second */
+int pad_monitor_rate(void);
+
+/* milliseconds on the clock used for changeTime */
+double pad_monitor_time(void);
+
+/* stop the thread and unload XInput */
+void pad_monitor_free(void);
+
+#endif  /* PAD_MONITOR_HPP */
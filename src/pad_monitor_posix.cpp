@@ -0,0 +1,66 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* There is no XInput outside of Wine; the controllers are mapped by Proton
+ * (through SDL) when the game runs, so the native launcher has nothing to
+ * poll and the gamepad view reports no controllers, like it does on Windows
+ * without XInput. */
+
+#include <string.h>
+
+#include "pad_monitor.hpp"
+
+
+bool pad_monitor_start(void (*)(void *), void *)
+{
+	return false;
+}
+
+void pad_monitor_stop(void)
+{
+}
+
+void pad_monitor_watch(nativeWindow)
+{
+}
+
+bool pad_monitor_status(int, pad_status_t *status)
+{
+	memset(status, 0, sizeof(*status));
+	return false;
+}
+
+int pad_monitor_rate(void)
+{
+	return 0;
+}
+
+double pad_monitor_time(void)
+{
+	return 0;
+}
+
+void pad_monitor_free(void)
+{
+}
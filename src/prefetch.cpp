@@ -0,0 +1,307 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "prefetch.hpp"
+#include "trace.hpp"
+
+#define PREFETCH_MAGIC      "SLP 1"
+#define PREFETCH_MAX_FILES  256
+
+
+static const confChar *gameDir = NULL;
+static volatile long cancel = 0;
+static bool running = false;
+static bool disabled = false;
+static uint64_t bytesRead = 0;
+
+/* from SonicLauncher.prefetch; learnDone is set once the files of the
+ * last session were looked up, only then the file is replaced */
+static int64_t lastLaunch = 0;
+static std::vector<std::string> learned;
+static bool learnDone = false;
+static bool atimeStale = false;
+
+
+/* ASCII only, the names that are compared against are */
+static bool same_name(const char *a, const char *b, size_t len)
+{
+	for (size_t i = 0; i < len; ++i) {
+		if (tolower(static_cast<uchar>(a[i])) != tolower(static_cast<uchar>(b[i]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool is_name(const std::string &name, const char *str)
+{
+	return name.size() == strlen(str) && same_name(name.c_str(), str, name.size());
+}
+
+static bool has_prefix(const std::string &name, const char *prefix)
+{
+	size_t len = strlen(prefix);
+	return name.size() >= len && same_name(name.c_str(), prefix, len);
+}
+
+static bool has_suffix(const std::string &name, const char *suffix)
+{
+	size_t len = strlen(suffix);
+	return name.size() > len && same_name(name.c_str() + name.size() - len, suffix, len);
+}
+
+/* the files of the launcher itself are never prefetched or learned */
+static bool launcher_file(const std::string &name)
+{
+	return has_prefix(name, "SonicLauncher") || is_name(name, "main.conf");
+}
+
+static bool by_use(const prefetch_file_t *a, const prefetch_file_t *b)
+{
+	return a->used < b->used;
+}
+
+static bool by_size(const prefetch_file_t *a, const prefetch_file_t *b)
+{
+	return a->size > b->size;
+}
+
+/* the magic line, the launch time and one file name per line */
+static void load_list(void)
+{
+	std::string data;
+	size_t pos, end;
+
+	lastLaunch = 0;
+	learned.clear();
+
+	if (!prefetch_load(gameDir, data) ||
+		(end = data.find('\n')) == std::string::npos ||
+		data.compare(0, end, PREFETCH_MAGIC) != 0)
+	{
+		return;
+	}
+
+	pos = end + 1;
+
+	if ((end = data.find('\n', pos)) == std::string::npos) {
+		return;
+	}
+	lastLaunch = strtoll(data.substr(pos, end - pos).c_str(), NULL, 10);
+
+	for (pos = end + 1; (end = data.find('\n', pos)) != std::string::npos; pos = end + 1) {
+		if (end > pos && learned.size() < PREFETCH_MAX_FILES) {
+			learned.push_back(data.substr(pos, end - pos));
+		}
+	}
+}
+
+/* the files accessed since the last launch, in the order they were used,
+ * followed by the ones learned before that weren't seen this time */
+static void learn(const std::vector<prefetch_file_t> &files)
+{
+	std::vector<const prefetch_file_t *> used;
+	std::vector<std::string> list;
+
+	if (lastLaunch != 0) {
+		/* the game was started after lastLaunch; if the access time of
+		 * Sonic_vis.exe is older, the file system doesn't update them
+		 * (disabled on NTFS, noatime or relatime) and nothing can be learned */
+		for (size_t i = 0; i < files.size(); ++i) {
+			if (is_name(files.at(i).name, "Sonic_vis.exe") && files.at(i).used < lastLaunch) {
+				atimeStale = true;
+				trace_counter("prefetch atime stale", 1);
+				return;
+			}
+		}
+
+		for (size_t i = 0; i < files.size(); ++i) {
+			if (files.at(i).used >= lastLaunch && !launcher_file(files.at(i).name)) {
+				used.push_back(&files.at(i));
+			}
+		}
+		std::stable_sort(used.begin(), used.end(), by_use);
+
+		for (size_t i = 0; i < used.size(); ++i) {
+			list.push_back(used.at(i)->name);
+		}
+	}
+
+	for (size_t i = 0; i < learned.size(); ++i) {
+		if (std::find(list.begin(), list.end(), learned.at(i)) == list.end()) {
+			list.push_back(learned.at(i));
+		}
+	}
+
+	if (list.size() > PREFETCH_MAX_FILES) {
+		list.resize(PREFETCH_MAX_FILES);
+	}
+
+	learned.swap(list);
+	learnDone = true;
+}
+
+/* Sonic_vis.exe, the DLLs next to it and the learned files (or the largest
+ * ones as long as nothing was learned), as many as fit into the budget */
+static void plan(const std::vector<prefetch_file_t> &files, std::vector<const prefetch_file_t *> &order)
+{
+	std::vector<const prefetch_file_t *> rest;
+	uint64_t total = 0;
+	size_t n = 0;
+
+	for (size_t i = 0; i < files.size(); ++i) {
+		const prefetch_file_t *f = &files.at(i);
+
+		if (launcher_file(f->name)) {
+			continue;
+		} else if (is_name(f->name, "Sonic_vis.exe")) {
+			order.insert(order.begin(), f);
+		} else if (f->name.find('/') == std::string::npos && has_suffix(f->name, ".dll")) {
+			order.push_back(f);
+		} else {
+			rest.push_back(f);
+		}
+	}
+
+	if (learned.empty()) {
+		std::stable_sort(rest.begin(), rest.end(), by_size);
+	} else {
+		std::vector<const prefetch_file_t *> list;
+
+		for (size_t i = 0; i < learned.size(); ++i) {
+			for (size_t j = 0; j < rest.size(); ++j) {
+				if (rest.at(j)->name == learned.at(i)) {
+					list.push_back(rest.at(j));
+					break;
+				}
+			}
+		}
+		rest.swap(list);
+	}
+
+	order.insert(order.end(), rest.begin(), rest.end());
+
+	for (size_t i = 0; i < order.size(); ++i) {
+		if (total + order.at(i)->size <= PREFETCH_BUDGET) {
+			total += order.at(i)->size;
+			order.at(n++) = order.at(i);
+		}
+	}
+	order.resize(n);
+}
+
+void prefetch_run(void)
+{
+	std::vector<prefetch_file_t> files;
+	std::vector<const prefetch_file_t *> order;
+
+	trace_begin("prefetch scan");
+	load_list();
+	prefetch_scan(gameDir, files, &cancel);
+	trace_end("prefetch scan");
+
+	if (cancel) {
+		return;
+	}
+
+	learn(files);
+	plan(files, order);
+
+	trace_begin("prefetch read");
+
+	for (size_t i = 0; i < order.size() && !cancel; ++i) {
+		bytesRead += prefetch_read(gameDir, order.at(i)->name, &cancel);
+	}
+
+	trace_end("prefetch read");
+}
+
+void prefetch_start(const confChar *dir)
+{
+	if (disabled || running) {
+		return;
+	}
+
+	gameDir = dir;
+	cancel = 0;
+	bytesRead = 0;
+	learnDone = false;
+	atimeStale = false;
+	running = prefetch_thread_start();
+}
+
+void prefetch_stop(bool launch)
+{
+	char buf[32];
+
+	if (!running) {
+		return;
+	}
+
+	/* a file that is being read is left after the current block */
+	cancel = 1;
+	prefetch_thread_join();
+	running = false;
+
+	trace_counter("prefetch KiB", static_cast<long long>(bytesRead / 1024));
+
+	if (!launch || !learnDone) {
+		return;
+	}
+
+	std::string data = PREFETCH_MAGIC "\n";
+	snprintf(buf, sizeof(buf), "%lld\n", static_cast<long long>(prefetch_clock()));
+	data += buf;
+
+	for (size_t i = 0; i < learned.size(); ++i) {
+		data += learned.at(i) + "\n";
+	}
+
+	prefetch_store(gameDir, data);
+}
+
+void prefetch_disable(void)
+{
+	disabled = true;
+}
+
+uint64_t prefetch_bytes(void)
+{
+	return bytesRead;
+}
+
+bool prefetch_atime_stale(void)
+{
+	return atimeStale;
+}
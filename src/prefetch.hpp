@@ -0,0 +1,102 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Background prefetch of the game files.
+ *
+ * While the settings window is open the disk is idle, so a low priority
+ * thread reads the files the game will need into the page cache: first
+ * Sonic_vis.exe and the DLLs next to it, then the files the game used in the
+ * previous sessions, up to PREFETCH_BUDGET bytes.
+ *
+ * The files are learned from their last access time.  The launch time is
+ * stored in SonicLauncher.prefetch when the game is started; the next time
+ * the launcher runs, every file that was accessed after it was used by that
+ * game session.  The prefetch itself doesn't change the access times.  As
+ * long as nothing was learned, the largest files are read instead.
+ *
+ * This only works if the file system updates the access times.  If the one
+ * of Sonic_vis.exe is older than the launch time, the list and the launch
+ * time are kept as they are.
+ */
+
+#ifndef PREFETCH_HPP
+#define PREFETCH_HPP
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "configuration.hpp"
+
+#define PREFETCH_BUDGET  (512ULL * 1024 * 1024)
+
+
+/* start the thread; `dir' is the game directory and must stay valid */
+void prefetch_start(const confChar *dir);
+
+/* stop the thread and wait for it; if `launch' is set the game is started
+ * now and the launch time is stored along with the learned files */
+void prefetch_stop(bool launch);
+
+/* don't prefetch (-NoPrefetch) */
+void prefetch_disable(void);
+
+/* bytes read, valid after prefetch_stop() */
+uint64_t prefetch_bytes(void);
+
+/* true if the last session wasn't learned because the access time of
+ * Sonic_vis.exe didn't change; valid after prefetch_stop() */
+bool prefetch_atime_stale(void);
+
+
+/* platform parts (prefetch_win32.cpp, prefetch_posix.cpp) */
+
+typedef struct {
+	std::string name;  /* UTF-8, relative to the game directory, '/' separated */
+	uint64_t size;
+	int64_t used;      /* last access time in prefetch_clock() units */
+} prefetch_file_t;
+
+/* the current time in the units of prefetch_file_t::used */
+int64_t prefetch_clock(void);
+
+/* all files below `dir'; stops early if `cancel' is set */
+void prefetch_scan(const confChar *dir, std::vector<prefetch_file_t> &files, volatile long *cancel);
+
+/* read a file into the page cache without changing its access time;
+ * stops early if `cancel' is set, returns the bytes read */
+uint64_t prefetch_read(const confChar *dir, const std::string &name, volatile long *cancel);
+
+/* SonicLauncher.prefetch in `dir' */
+bool prefetch_load(const confChar *dir, std::string &data);
+bool prefetch_store(const confChar *dir, const std::string &data);
+
+/* run prefetch_run() on a thread with low CPU and I/O priority */
+bool prefetch_thread_start(void);
+void prefetch_thread_join(void);
+void prefetch_run(void);
+
+#endif  /* PREFETCH_HPP */
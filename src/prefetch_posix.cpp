@@ -0,0 +1,198 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "prefetch.hpp"
+
+#define PREFETCH_FILE  "/SonicLauncher.prefetch"
+#define PREFETCH_MAX   (64 * 1024)
+#define READ_BLOCK     (256 * 1024)
+#define SCAN_DEPTH     4
+
+/* from linux/ioprio.h */
+#define IOPRIO_CLASS_IDLE   3
+#define IOPRIO_CLASS_SHIFT  13
+#define IOPRIO_WHO_PROCESS  1
+
+
+static pthread_t thread;
+static bool threadRunning = false;
+
+
+int64_t prefetch_clock(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static void scan(const std::string &dir, const std::string &prefix, int depth,
+	std::vector<prefetch_file_t> &files, volatile long *cancel)
+{
+	DIR *d = opendir(dir.c_str());
+	struct dirent *e;
+	struct stat st;
+
+	if (!d) {
+		return;
+	}
+
+	while (*cancel == 0 && (e = readdir(d)) != NULL) {
+		if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0 ||
+			fstatat(dirfd(d), e->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+		{
+			continue;
+		}
+
+		std::string name = prefix + e->d_name;
+
+		if (S_ISDIR(st.st_mode)) {
+			if (depth > 0) {
+				scan(dir + "/" + e->d_name, name + "/", depth - 1, files, cancel);
+			}
+		} else if (S_ISREG(st.st_mode)) {
+			prefetch_file_t f;
+			f.name = name;
+			f.size = static_cast<uint64_t>(st.st_size);
+			f.used = static_cast<int64_t>(st.st_atim.tv_sec) * 1000000000 + st.st_atim.tv_nsec;
+			files.push_back(f);
+		}
+	}
+
+	closedir(d);
+}
+
+void prefetch_scan(const confChar *dir, std::vector<prefetch_file_t> &files, volatile long *cancel)
+{
+	scan(dir, "", SCAN_DEPTH, files, cancel);
+}
+
+uint64_t prefetch_read(const confChar *dir, const std::string &name, volatile long *cancel)
+{
+	std::string path = std::string(dir) + "/" + name;
+	std::vector<char> buf(READ_BLOCK);
+	uint64_t total = 0;
+	ssize_t n;
+
+	/* keep the access time, it tells which files the game used; that's
+	 * only allowed for the owner of the file */
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NOATIME);
+
+	if (fd == -1 && errno == EPERM) {
+		fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	}
+	if (fd == -1) {
+		return 0;
+	}
+
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	while (*cancel == 0) {
+		n = read(fd, buf.data(), buf.size());
+
+		if (n == -1 && errno == EINTR) {
+			continue;
+		} else if (n <= 0) {
+			break;
+		}
+		total += static_cast<uint64_t>(n);
+	}
+
+	close(fd);
+
+	return total;
+}
+
+bool prefetch_load(const confChar *dir, std::string &data)
+{
+	std::string path = std::string(dir) + PREFETCH_FILE;
+	FILE *fp = fopen(path.c_str(), "rb");
+	char buf[4096];
+	size_t n;
+
+	if (!fp) {
+		return false;
+	}
+
+	while ((n = fread(buf, 1, sizeof(buf), fp)) > 0 && data.size() < PREFETCH_MAX) {
+		data.append(buf, n);
+	}
+	fclose(fp);
+
+	return true;
+}
+
+bool prefetch_store(const confChar *dir, const std::string &data)
+{
+	std::string path = std::string(dir) + PREFETCH_FILE;
+	FILE *fp = fopen(path.c_str(), "wb");
+
+	if (!fp) {
+		return false;
+	}
+
+	bool rv = (fwrite(data.data(), 1, data.size(), fp) == data.size());
+
+	return (fclose(fp) == 0 && rv);
+}
+
+static void *prefetch_thread(void *)
+{
+	/* the idle class only gets the disk when nobody else wants it; both
+	 * calls only affect this thread */
+	syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+	setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+
+	prefetch_run();
+	return NULL;
+}
+
+bool prefetch_thread_start(void)
+{
+	threadRunning = (pthread_create(&thread, NULL, prefetch_thread, NULL) == 0);
+	return threadRunning;
+}
+
+void prefetch_thread_join(void)
+{
+	if (threadRunning) {
+		pthread_join(thread, NULL);
+		threadRunning = false;
+	}
+}
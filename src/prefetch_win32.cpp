@@ -0,0 +1,216 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <windows.h>
+#include <process.h>
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "prefetch.hpp"
+
+#define PREFETCH_FILE  L"\\SonicLauncher.prefetch"
+#define PREFETCH_MAX   (64 * 1024)
+#define READ_BLOCK     (256 * 1024)
+#define SCAN_DEPTH     4
+
+
+static HANDLE thread = NULL;
+
+
+static std::string narrow(const wchar_t *str)
+{
+	char buf[MAX_PATH * 3];
+	int n = WideCharToMultiByte(CP_UTF8, 0, str, -1, buf, sizeof(buf), NULL, NULL);
+	return (n > 0) ? std::string(buf) : std::string();
+}
+
+/* UTF-8 name relative to `dir' to a Windows path */
+static std::wstring full_path(const confChar *dir, const std::string &name)
+{
+	wchar_t buf[MAX_PATH];
+	std::wstring path(dir);
+
+	if (MultiByteToWideChar(CP_UTF8, 0, name.c_str(), -1, buf, MAX_PATH) <= 0) {
+		return std::wstring();
+	}
+
+	path += L'\\';
+
+	for (wchar_t *p = buf; *p; ++p) {
+		path += (*p == L'/') ? L'\\' : *p;
+	}
+	return path;
+}
+
+static int64_t filetime(const FILETIME &ft)
+{
+	return static_cast<int64_t>(static_cast<uint64_t>(ft.dwHighDateTime) << 32 | ft.dwLowDateTime);
+}
+
+int64_t prefetch_clock(void)
+{
+	FILETIME ft;
+
+	GetSystemTimeAsFileTime(&ft);
+	return filetime(ft);
+}
+
+static void scan(const std::wstring &dir, const std::string &prefix, int depth,
+	std::vector<prefetch_file_t> &files, volatile long *cancel)
+{
+	WIN32_FIND_DATAW fd;
+	HANDLE h = FindFirstFileW((dir + L"\\*").c_str(), &fd);
+
+	if (h == INVALID_HANDLE_VALUE) {
+		return;
+	}
+
+	do {
+		/* don't follow junctions */
+		if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0 ||
+			(fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+		{
+			continue;
+		}
+
+		std::string name = prefix + narrow(fd.cFileName);
+
+		if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+			if (depth > 0) {
+				scan(dir + L"\\" + fd.cFileName, name + "/", depth - 1, files, cancel);
+			}
+		} else {
+			prefetch_file_t f;
+			f.name = name;
+			f.size = static_cast<uint64_t>(fd.nFileSizeHigh) << 32 | fd.nFileSizeLow;
+			f.used = filetime(fd.ftLastAccessTime);
+			files.push_back(f);
+		}
+	} while (*cancel == 0 && FindNextFileW(h, &fd));
+
+	FindClose(h);
+}
+
+void prefetch_scan(const confChar *dir, std::vector<prefetch_file_t> &files, volatile long *cancel)
+{
+	scan(dir, "", SCAN_DEPTH, files, cancel);
+}
+
+uint64_t prefetch_read(const confChar *dir, const std::string &name, volatile long *cancel)
+{
+	std::wstring path = full_path(dir, name);
+	std::vector<char> buf(READ_BLOCK);
+	FILETIME keep = { 0xFFFFFFFF, 0xFFFFFFFF };
+	uint64_t total = 0;
+	DWORD n;
+	HANDLE h;
+
+	if (path.empty()) {
+		return 0;
+	}
+
+	/* keep the last access time, it tells which files the game used;
+	 * that needs FILE_WRITE_ATTRIBUTES, which a user may not have */
+	h = CreateFileW(path.c_str(), GENERIC_READ | FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (h != INVALID_HANDLE_VALUE) {
+		SetFileTime(h, NULL, &keep, NULL);
+	} else {
+		h = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	}
+
+	if (h == INVALID_HANDLE_VALUE) {
+		return 0;
+	}
+
+	while (*cancel == 0 && ReadFile(h, buf.data(), READ_BLOCK, &n, NULL) && n > 0) {
+		total += n;
+	}
+
+	CloseHandle(h);
+
+	return total;
+}
+
+bool prefetch_load(const confChar *dir, std::string &data)
+{
+	std::wstring path = std::wstring(dir) + PREFETCH_FILE;
+	FILE *fp = NULL;
+	char buf[4096];
+	size_t n;
+
+	if (_wfopen_s(&fp, path.c_str(), L"rb") != 0) {
+		return false;
+	}
+
+	while ((n = fread(buf, 1, sizeof(buf), fp)) > 0 && data.size() < PREFETCH_MAX) {
+		data.append(buf, n);
+	}
+	fclose(fp);
+
+	return true;
+}
+
+bool prefetch_store(const confChar *dir, const std::string &data)
+{
+	std::wstring path = std::wstring(dir) + PREFETCH_FILE;
+	FILE *fp = NULL;
+
+	if (_wfopen_s(&fp, path.c_str(), L"wb") != 0) {
+		return false;
+	}
+
+	bool rv = (fwrite(data.data(), 1, data.size(), fp) == data.size());
+
+	return (fclose(fp) == 0 && rv);
+}
+
+static unsigned __stdcall prefetch_thread(void *)
+{
+	/* lowers the I/O and memory priority of the thread as well */
+	SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+	prefetch_run();
+	return 0;
+}
+
+bool prefetch_thread_start(void)
+{
+	thread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, prefetch_thread, NULL, 0, NULL));
+	return (thread != NULL);
+}
+
+void prefetch_thread_join(void)
+{
+	if (thread) {
+		WaitForSingleObject(thread, INFINITE);
+		CloseHandle(thread);
+		thread = NULL;
+	}
+}
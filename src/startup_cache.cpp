@@ -0,0 +1,528 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <windows.h>
+
+#include <FL/Fl.H>
+#include <FL/Enumerations.H>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "startup_cache.hpp"
+#include "trace.hpp"
+
+#define CACHE_MAGIC     "SLC"
+#define CACHE_VERSION   2
+#define CACHE_MAX_SIZE  (1024 * 1024)
+
+
+enum {
+	FP_DISPLAY,
+	FP_FONT,
+	FP_KEYS,  /* keyboard layout and font, the labels are shortened to fit */
+	FP_COUNT
+};
+
+/* fingerprints read from the file and the current ones (0 = not computed yet) */
+static uint64_t fileFp[FP_COUNT];
+static uint64_t currentFp[FP_COUNT];
+
+static std::map<uchar, modeTable> reslists;
+static std::map<uint32_t, std::string> keylabels;
+static std::map<std::pair<uint32_t, std::string>, int> widths;
+
+static const wchar_t *cacheFile = NULL;
+static bool dirty = false;
+static bool disabled = false;
+
+
+/* FNV-1a */
+static uint64_t hash_bytes(uint64_t h, const void *data, size_t len)
+{
+	const uchar *p = reinterpret_cast<const uchar *>(data);
+
+	for (size_t i = 0; i < len; ++i) {
+		h ^= p[i];
+		h *= 0x100000001B3ULL;
+	}
+	return h;
+}
+
+static uint64_t hash_str(uint64_t h, const char *str)
+{
+	/* include the terminating null byte, so "ab"+"c" != "a"+"bc" */
+	return hash_bytes(h, str, strlen(str) + 1);
+}
+
+/* DeviceKey is a kernel path like "\Registry\Machine\System\..." */
+static void driver_version(const char *deviceKey, char *buf, DWORD size)
+{
+	const char *prefix = "\\Registry\\Machine\\";
+	size_t len = strlen(prefix);
+	HKEY key;
+
+	buf[0] = 0;
+
+	if (_strnicmp(deviceKey, prefix, len) != 0 ||
+		RegOpenKeyExA(HKEY_LOCAL_MACHINE, deviceKey + len, 0, KEY_QUERY_VALUE, &key) != ERROR_SUCCESS)
+	{
+		return;
+	}
+
+	if (RegQueryValueExA(key, "DriverVersion", NULL, NULL, reinterpret_cast<LPBYTE>(buf), &size) != ERROR_SUCCESS) {
+		buf[0] = 0;
+	} else {
+		buf[size > 0 ? size - 1 : 0] = 0;
+	}
+	RegCloseKey(key);
+}
+
+static uint64_t fingerprint_display(void)
+{
+	DISPLAY_DEVICEA adapter, monitor;
+	char version[128];
+	uint64_t h = 0xCBF29CE484222325ULL;
+
+	memset(&adapter, 0, sizeof(adapter));
+	adapter.cb = sizeof(adapter);
+
+	for (DWORD i = 0; EnumDisplayDevicesA(NULL, i, &adapter, 0); ++i) {
+		h = hash_str(h, adapter.DeviceName);
+		h = hash_str(h, adapter.DeviceString);
+		h = hash_str(h, adapter.DeviceID);
+		h = hash_bytes(h, &adapter.StateFlags, sizeof(adapter.StateFlags));
+
+		driver_version(adapter.DeviceKey, version, sizeof(version));
+		h = hash_str(h, version);
+
+		memset(&monitor, 0, sizeof(monitor));
+		monitor.cb = sizeof(monitor);
+
+		for (DWORD j = 0; EnumDisplayDevicesA(adapter.DeviceName, j, &monitor, 0); ++j) {
+			h = hash_str(h, monitor.DeviceID);
+			h = hash_bytes(h, &monitor.StateFlags, sizeof(monitor.StateFlags));
+		}
+	}
+
+	return h;
+}
+
+static uint64_t fingerprint_font(void)
+{
+	uint64_t h = 0xCBF29CE484222325ULL;
+	int version = FL_MAJOR_VERSION * 10000 + FL_MINOR_VERSION * 100 + FL_PATCH_VERSION;
+	int dpi = 0;
+	HDC dc = GetDC(NULL);
+
+	if (dc) {
+		dpi = GetDeviceCaps(dc, LOGPIXELSY);
+		ReleaseDC(NULL, dc);
+	}
+
+	h = hash_bytes(h, &version, sizeof(version));
+	h = hash_bytes(h, &dpi, sizeof(dpi));
+	h = hash_str(h, Fl::get_font(FL_HELVETICA));
+	h = hash_str(h, Fl::get_font(FL_HELVETICA_BOLD));
+
+	return h;
+}
+
+static uint64_t fingerprint_keys(void)
+{
+	uint64_t h = fingerprint_font();
+	uintptr_t hkl = reinterpret_cast<uintptr_t>(GetKeyboardLayout(0));
+	return hash_bytes(h, &hkl, sizeof(hkl));
+}
+
+/* compute the fingerprint of a section on first use and drop the cached
+ * data if it doesn't match; returns false if the cache is disabled */
+static bool validate(int fp)
+{
+	if (disabled) {
+		return false;
+	}
+
+	if (currentFp[fp] != 0) {
+		return true;
+	}
+
+	trace_begin("cache fingerprint");
+
+	switch (fp) {
+	case FP_DISPLAY:
+		currentFp[fp] = fingerprint_display();
+		break;
+	case FP_FONT:
+		currentFp[fp] = fingerprint_font();
+		break;
+	case FP_KEYS:
+		currentFp[fp] = fingerprint_keys();
+		break;
+	default:
+		break;
+	}
+
+	trace_end("cache fingerprint");
+
+	if (currentFp[fp] != fileFp[fp]) {
+		switch (fp) {
+		case FP_DISPLAY:
+			reslists.clear();
+			break;
+		case FP_FONT:
+			widths.clear();
+			break;
+		case FP_KEYS:
+			keylabels.clear();
+			break;
+		default:
+			break;
+		}
+		fileFp[fp] = currentFp[fp];
+		dirty = true;
+	}
+
+	return true;
+}
+
+
+/* file format, all numbers little endian:
+ *
+ * "SLC" version
+ * u64 fingerprint[FP_COUNT]
+ * u16 count, count * { u8 display, u16 n, n * { u16 w, u16 h } }
+ * u16 count, count * { u8 dx, u16 limit, u8 len, char label[len] }
+ * u16 count, count * { u16 font, u16 size, u16 width, u8 len, char text[len] }
+ */
+
+class reader
+{
+private:
+	const uchar *_p;
+	const uchar *_end;
+	bool _ok = true;
+
+public:
+	reader(const uchar *p, size_t len)
+		: _p(p), _end(p + len)
+	{}
+
+	bool ok() { return _ok; }
+
+	const uchar *bytes(size_t n) {
+		if (!_ok || static_cast<size_t>(_end - _p) < n) {
+			_ok = false;
+			return NULL;
+		}
+		const uchar *p = _p;
+		_p += n;
+		return p;
+	}
+
+	uint64_t num(size_t n) {
+		const uchar *p = bytes(n);
+		uint64_t v = 0;
+
+		for (size_t i = 0; p && i < n; ++i) {
+			v |= static_cast<uint64_t>(p[i]) << (i * 8);
+		}
+		return v;
+	}
+
+	std::string str(size_t n) {
+		const uchar *p = bytes(n);
+		return p ? std::string(reinterpret_cast<const char *>(p), n) : std::string();
+	}
+};
+
+static void put_num(std::vector<uchar> &buf, uint64_t v, size_t n)
+{
+	for (size_t i = 0; i < n; ++i) {
+		buf.push_back(static_cast<uchar>(v >> (i * 8)));
+	}
+}
+
+static void put_str(std::vector<uchar> &buf, const std::string &str)
+{
+	buf.insert(buf.end(), str.begin(), str.end());
+}
+
+static bool parse(const uchar *data, size_t len)
+{
+	reader r(data, len);
+	const uchar *magic = r.bytes(4);
+
+	if (!magic || memcmp(magic, CACHE_MAGIC, 3) != 0 || magic[3] != CACHE_VERSION) {
+		return false;
+	}
+
+	for (int i = 0; i < FP_COUNT; ++i) {
+		fileFp[i] = r.num(8);
+	}
+
+	size_t count = static_cast<size_t>(r.num(2));
+
+	for (size_t i = 0; i < count && r.ok(); ++i) {
+		uchar display = static_cast<uchar>(r.num(1));
+		size_t n = static_cast<size_t>(r.num(2));
+		modeTable &list = reslists[display];
+
+		for (size_t j = 0; j < n && r.ok(); ++j) {
+			uint16_t w = static_cast<uint16_t>(r.num(2));
+			uint16_t h = static_cast<uint16_t>(r.num(2));
+			list.add(w, h);
+		}
+	}
+
+	count = static_cast<size_t>(r.num(2));
+
+	for (size_t i = 0; i < count && r.ok(); ++i) {
+		uint32_t dx = static_cast<uint32_t>(r.num(1));
+		uint32_t limit = static_cast<uint32_t>(r.num(2));
+		std::string label = r.str(static_cast<size_t>(r.num(1)));
+		keylabels[dx << 16 | limit] = label;
+	}
+
+	count = static_cast<size_t>(r.num(2));
+
+	for (size_t i = 0; i < count && r.ok(); ++i) {
+		uint32_t font = static_cast<uint32_t>(r.num(2));
+		uint32_t size = static_cast<uint32_t>(r.num(2));
+		int width = static_cast<int>(r.num(2));
+		std::string text = r.str(static_cast<size_t>(r.num(1)));
+		widths[std::make_pair(font << 16 | size, text)] = width;
+	}
+
+	return r.ok();
+}
+
+bool cache_load(const wchar_t *filename)
+{
+	FILE *fp = NULL;
+	std::vector<uchar> buf;
+	long len;
+	bool rv = false;
+
+	TraceScope ts("cache_load");
+
+	cache_reset();
+	cacheFile = filename;
+
+	if (disabled || _wfopen_s(&fp, filename, L"rb") != 0) {
+		return false;
+	}
+
+	if (fseek(fp, 0, SEEK_END) == 0 && (len = ftell(fp)) > 0 && len <= CACHE_MAX_SIZE) {
+		buf.resize(static_cast<size_t>(len));
+		rewind(fp);
+
+		if (fread(buf.data(), 1, buf.size(), fp) == buf.size()) {
+			rv = parse(buf.data(), buf.size());
+		}
+	}
+	fclose(fp);
+
+	if (!rv) {
+		/* start over, the file will be rewritten */
+		cache_reset();
+		cacheFile = filename;
+		dirty = true;
+	}
+
+	return rv;
+}
+
+bool cache_save(void)
+{
+	std::vector<uchar> buf;
+	FILE *fp = NULL;
+
+	if (disabled || !dirty || !cacheFile) {
+		return false;
+	}
+
+	TraceScope ts("cache_save");
+
+	put_str(buf, CACHE_MAGIC);
+	buf.push_back(CACHE_VERSION);
+
+	for (int i = 0; i < FP_COUNT; ++i) {
+		put_num(buf, fileFp[i], 8);
+	}
+
+	put_num(buf, reslists.size(), 2);
+
+	for (auto it = reslists.begin(); it != reslists.end(); ++it) {
+		put_num(buf, it->first, 1);
+		put_num(buf, it->second.size(), 2);
+
+		for (size_t j = 0; j < it->second.size(); ++j) {
+			put_num(buf, it->second.w(j), 2);
+			put_num(buf, it->second.h(j), 2);
+		}
+	}
+
+	put_num(buf, keylabels.size(), 2);
+
+	for (auto it = keylabels.begin(); it != keylabels.end(); ++it) {
+		put_num(buf, it->first >> 16, 1);
+		put_num(buf, it->first & 0xFFFF, 2);
+		put_num(buf, it->second.size(), 1);
+		put_str(buf, it->second);
+	}
+
+	put_num(buf, widths.size(), 2);
+
+	for (auto it = widths.begin(); it != widths.end(); ++it) {
+		put_num(buf, it->first.first >> 16, 2);
+		put_num(buf, it->first.first & 0xFFFF, 2);
+		put_num(buf, static_cast<uint64_t>(it->second), 2);
+		put_num(buf, it->first.second.size(), 1);
+		put_str(buf, it->first.second);
+	}
+
+	if (_wfopen_s(&fp, cacheFile, L"wb") != 0) {
+		return false;
+	}
+
+	bool rv = (fwrite(buf.data(), 1, buf.size(), fp) == buf.size());
+	fclose(fp);
+
+	if (rv) {
+		dirty = false;
+	}
+	return rv;
+}
+
+void cache_reset(void)
+{
+	reslists.clear();
+	keylabels.clear();
+	widths.clear();
+
+	for (int i = 0; i < FP_COUNT; ++i) {
+		fileFp[i] = currentFp[i] = 0;
+	}
+	dirty = false;
+}
+
+void cache_disable(void)
+{
+	cache_reset();
+	disabled = true;
+}
+
+bool cache_get_reslist(uchar display, modeTable &list)
+{
+	if (!validate(FP_DISPLAY)) {
+		return false;
+	}
+
+	auto it = reslists.find(display);
+
+	if (it == reslists.end() || it->second.empty()) {
+		return false;
+	}
+
+	list = it->second;
+	return true;
+}
+
+void cache_put_reslist(uchar display, const modeTable &list)
+{
+	/* the format has no room for more */
+	if (!validate(FP_DISPLAY) || list.size() > 0xFFFF || reslists.size() >= 0xFF) {
+		return;
+	}
+
+	reslists[display] = list;
+	dirty = true;
+}
+
+void cache_refresh_displays(void)
+{
+	currentFp[FP_DISPLAY] = 0;
+}
+
+void cache_refresh_keys(void)
+{
+	currentFp[FP_KEYS] = 0;
+}
+
+bool cache_get_keylabel(uchar dx, int limit, char *buf, size_t size)
+{
+	if (!validate(FP_KEYS) || limit < 0 || limit > 0xFFFF) {
+		return false;
+	}
+
+	auto it = keylabels.find(static_cast<uint32_t>(dx) << 16 | static_cast<uint32_t>(limit));
+
+	if (it == keylabels.end() || it->second.size() >= size) {
+		return false;
+	}
+
+	memcpy(buf, it->second.c_str(), it->second.size() + 1);
+	return true;
+}
+
+void cache_put_keylabel(uchar dx, int limit, const char *label)
+{
+	if (!validate(FP_KEYS) || limit < 0 || limit > 0xFFFF || strlen(label) > 0xFF ||
+		keylabels.size() >= 0xFFFF)
+	{
+		return;
+	}
+
+	keylabels[static_cast<uint32_t>(dx) << 16 | static_cast<uint32_t>(limit)] = label;
+	dirty = true;
+}
+
+int cache_get_width(const char *text, int font, int size)
+{
+	if (!validate(FP_FONT)) {
+		return -1;
+	}
+
+	auto it = widths.find(std::make_pair(static_cast<uint32_t>(font) << 16 | static_cast<uint32_t>(size), std::string(text)));
+	return (it == widths.end()) ? -1 : it->second;
+}
+
+void cache_put_width(const char *text, int font, int size, int width)
+{
+	if (!validate(FP_FONT) || font < 0 || font > 0xFFFF || size < 0 || size > 0xFFFF ||
+		width < 0 || width > 0xFFFF || strlen(text) > 0xFF || widths.size() >= 0xFFFF)
+	{
+		return;
+	}
+
+	widths[std::make_pair(static_cast<uint32_t>(font) << 16 | static_cast<uint32_t>(size), std::string(text))] = width;
+	dirty = true;
+}
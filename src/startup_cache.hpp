@@ -0,0 +1,76 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Persistent startup cache.
+ *
+ * Results that are expensive to compute but rarely change are kept in a small
+ * file next to main.conf: the resolution list of each display, the key labels
+ * of the key binding buttons and the width of label texts.
+ *
+ * Each kind of data is stored together with a fingerprint of what it depends
+ * on (display adapters and monitors with their driver versions, the keyboard
+ * layout, the label font and the DPI).  The fingerprints are computed when a
+ * kind of data is first accessed; if it doesn't match the one from the file,
+ * that part of the cache is dropped and recomputed.
+ */
+
+#ifndef STARTUP_CACHE_HPP
+#define STARTUP_CACHE_HPP
+
+#include <stddef.h>
+
+#include "configuration.hpp"
+
+/* load the cache; a missing or corrupt file results in an empty cache */
+bool cache_load(const confChar *filename);
+
+/* write the cache back if anything was added */
+bool cache_save(void);
+
+/* forget everything (the file is left alone) */
+void cache_reset(void);
+
+/* disable the cache: nothing is returned and nothing is saved */
+void cache_disable(void);
+
+/* deduplicated resolution list of a display */
+bool cache_get_reslist(uchar display, modeTable &list);
+void cache_put_reslist(uchar display, const modeTable &list);
+
+/* the displays changed: check the display fingerprint again on next access */
+void cache_refresh_displays(void);
+
+/* the keyboard layout changed: check the key fingerprint again on next access */
+void cache_refresh_keys(void);
+
+/* UTF-8 key name of a DirectInput key, already shortened to fit into `limit' pixels */
+bool cache_get_keylabel(uchar dx, int limit, char *buf, size_t size);
+void cache_put_keylabel(uchar dx, int limit, const char *label);
+
+/* width of a text in pixels; returns -1 if it's not cached */
+int cache_get_width(const char *text, int font, int size);
+void cache_put_width(const char *text, int font, int size, int width);
+
+#endif  /* STARTUP_CACHE_HPP */
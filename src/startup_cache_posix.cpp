@@ -0,0 +1,84 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* What the startup cache saves on Windows (EnumDisplaySettings(), the key
+ * names of the layout, GDI text widths) is cheap with XRandR and XKB, and its
+ * fingerprints are made of Windows display devices and keyboard layouts.
+ * The native Linux build therefore runs with the cache disabled. */
+
+#include "startup_cache.hpp"
+
+
+bool cache_load(const confChar *)
+{
+	return false;
+}
+
+bool cache_save(void)
+{
+	return false;
+}
+
+void cache_reset(void)
+{
+}
+
+void cache_disable(void)
+{
+}
+
+bool cache_get_reslist(uchar, modeTable &)
+{
+	return false;
+}
+
+void cache_put_reslist(uchar, const modeTable &)
+{
+}
+
+void cache_refresh_displays(void)
+{
+}
+
+void cache_refresh_keys(void)
+{
+}
+
+bool cache_get_keylabel(uchar, int, char *, size_t)
+{
+	return false;
+}
+
+void cache_put_keylabel(uchar, int, const char *)
+{
+}
+
+int cache_get_width(const char *, int, int)
+{
+	return -1;
+}
+
+void cache_put_width(const char *, int, int, int)
+{
+}
@@ -0,0 +1,224 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "text_fit.hpp"
+
+
+typedef struct {
+	int font;
+	int size;
+	double ascii[128];  /* < 0 until measured */
+	std::map<unsigned int, double> other;
+} glyphCache_t;
+
+
+static glyphSource *source = NULL;
+static std::vector<glyphCache_t *> caches;
+static glyphCache_t *last = NULL;  /* the cache used last */
+
+/* end of each character and the width up to there; kept to save allocations */
+static std::vector<int> prefixEnd;
+static std::vector<double> prefixWidth;
+
+
+static glyphCache_t *find_cache(int font, int size)
+{
+	if (last && last->font == font && last->size == size) {
+		return last;
+	}
+
+	for (size_t i = 0; i < caches.size(); ++i) {
+		if (caches.at(i)->font == font && caches.at(i)->size == size) {
+			last = caches.at(i);
+			return last;
+		}
+	}
+
+	last = new glyphCache_t;
+	last->font = font;
+	last->size = size;
+	std::fill(last->ascii, last->ascii + 128, -1.0);
+	caches.push_back(last);
+
+	return last;
+}
+
+/* Windows-1252 characters for the bytes 0x80 to 0x9F */
+static const unsigned short cp1252[32] = {
+	0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+	0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+};
+
+/* decode a character with the same rules as fl_utf8decode(): invalid bytes
+ * are taken as Windows-1252 or ISO-8859-1 with a length of 1 */
+static unsigned int utf8_decode(const unsigned char *p, const unsigned char *end, int *len)
+{
+	unsigned int c = p[0];
+	int n;
+
+	*len = 1;
+
+	if (c < 0x80) {
+		return c;
+	} else if (c < 0xA0) {
+		return cp1252[c - 0x80];
+	} else if (c < 0xC2 || c > 0xF4) {
+		return c;
+	}
+
+	n = (c < 0xE0) ? 2 : (c < 0xF0) ? 3 : 4;
+
+	if (end - p < n ||
+		(c == 0xE0 && p[1] < 0xA0) ||
+		(c == 0xF0 && p[1] < 0x90) ||
+		(c == 0xF4 && p[1] > 0x8F))
+	{
+		return c;
+	}
+
+	for (int i = 1; i < n; ++i) {
+		if ((p[i] & 0xC0) != 0x80) {
+			return c;
+		}
+	}
+
+	*len = n;
+
+	if (n == 2) {
+		return (c & 0x1F) << 6 | (p[1] & 0x3F);
+	} else if (n == 3) {
+		return (c & 0x0F) << 12 | (p[1] & 0x3F) << 6 | (p[2] & 0x3F);
+	}
+	return (c & 0x07) << 18 | (p[1] & 0x3F) << 12 | (p[2] & 0x3F) << 6 | (p[3] & 0x3F);
+}
+
+class glyphMeasure
+{
+private:
+	glyphCache_t *_cache;
+	bool _measured = false;
+
+	double measure(unsigned int c) {
+		_measured = true;
+		return source->advance(c, _cache->font, _cache->size);
+	}
+
+public:
+	glyphMeasure(int font, int size) : _cache(find_cache(font, size)) {}
+
+	~glyphMeasure() {
+		if (_measured) {
+			source->done();
+		}
+	}
+
+	double advance(unsigned int c) {
+		if (c < 128) {
+			if (_cache->ascii[c] < 0) {
+				_cache->ascii[c] = measure(c);
+			}
+			return _cache->ascii[c];
+		}
+
+		auto it = _cache->other.find(c);
+
+		if (it != _cache->other.end()) {
+			return it->second;
+		}
+
+		double w = measure(c);
+		_cache->other[c] = w;
+		return w;
+	}
+};
+
+/* add up the prefix widths; returns the number of characters */
+static size_t measure_prefixes(const char *text, int font, int size)
+{
+	glyphMeasure gm(font, size);
+	const unsigned char *start = reinterpret_cast<const unsigned char *>(text);
+	const unsigned char *p = start;
+	const unsigned char *end = start + strlen(text);
+	double w = 0;
+
+	prefixEnd.clear();
+	prefixWidth.clear();
+
+	while (p < end) {
+		int len;
+		unsigned int c = utf8_decode(p, end, &len);
+
+		p += len;
+		w += gm.advance(c);
+		prefixEnd.push_back(static_cast<int>(p - start));
+		prefixWidth.push_back(w);
+	}
+
+	return prefixEnd.size();
+}
+
+void text_fit_source(glyphSource *src)
+{
+	source = src;
+}
+
+int text_width(const char *text, int font, int size)
+{
+	if (!text || measure_prefixes(text, font, size) == 0) {
+		return 0;
+	}
+	return static_cast<int>(prefixWidth.back());
+}
+
+int text_fit(const char *text, int font, int size, int limit)
+{
+	if (!text || measure_prefixes(text, font, size) == 0) {
+		return 0;
+	}
+
+	/* first prefix that is too wide */
+	auto it = std::upper_bound(prefixWidth.begin(), prefixWidth.end(), limit,
+		[] (int l, double w) { return static_cast<int>(w) > l; });
+
+	size_t n = static_cast<size_t>(it - prefixWidth.begin());
+	return (n == 0) ? 0 : prefixEnd.at(n - 1);
+}
+
+void text_fit_clear(void)
+{
+	for (size_t i = 0; i < caches.size(); ++i) {
+		delete caches.at(i);
+	}
+
+	caches.clear();
+	last = NULL;
+}
@@ -0,0 +1,74 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Text fitting.
+ *
+ * The advance of every glyph is measured once per font and size and kept in
+ * a table.  The width of a text is the sum of its advances, which is also how
+ * fl_width() computes it, so no text is measured twice.  To shorten a label,
+ * the widths of all its prefixes are added up in one pass and the longest
+ * prefix that fits is found with a binary search; the text is only ever cut
+ * between two UTF-8 characters.
+ *
+ * The glyphs are measured by a glyphSource, so this doesn't depend on FLTK;
+ * text_fit_fltk() measures them with fl_width().
+ *
+ * Everything here runs on the main thread.
+ */
+
+#ifndef TEXT_FIT_HPP
+#define TEXT_FIT_HPP
+
+class glyphSource
+{
+public:
+	virtual ~glyphSource() {}
+
+	/* advance of a character in pixels */
+	virtual double advance(unsigned int c, int font, int size) = 0;
+
+	/* called after a text was measured if advance() was called for it */
+	virtual void done() {}
+};
+
+/* select where glyphs are measured; must be called before anything is
+ * measured, the cached widths are kept */
+void text_fit_source(glyphSource *src);
+
+/* measures with fl_width() in the current FLTK graphics context
+ * (text_fit_fltk.cpp) */
+glyphSource *text_fit_fltk(void);
+
+/* width of a UTF-8 text in pixels, truncated like fl_width() */
+int text_width(const char *text, int font, int size);
+
+/* length in bytes of the longest prefix of a UTF-8 text that is at most
+ * `limit' pixels wide */
+int text_fit(const char *text, int font, int size, int limit);
+
+/* forget all measured glyphs */
+void text_fit_clear(void);
+
+#endif  /* TEXT_FIT_HPP */
@@ -0,0 +1,62 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <FL/fl_draw.H>
+
+#include "text_fit.hpp"
+
+
+class fltkGlyphs : public glyphSource
+{
+private:
+	Fl_Font _prevFont = 0;
+	Fl_Fontsize _prevSize = 0;
+	bool _switched = false;
+
+public:
+	/* select the font only if a glyph has to be measured */
+	double advance(unsigned int c, int font, int size) {
+		if (!_switched) {
+			_prevFont = fl_font();
+			_prevSize = fl_size();
+			fl_font(font, size);
+			_switched = true;
+		}
+		return fl_width(c);
+	}
+
+	void done() {
+		if (_switched) {
+			fl_font(_prevFont, _prevSize);
+			_switched = false;
+		}
+	}
+};
+
+
+glyphSource *text_fit_fltk(void)
+{
+	static fltkGlyphs glyphs;
+	return &glyphs;
+}
@@ -0,0 +1,54 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Labels that need to be shortened, shared by the label fitting check of
+ * the launcher (-FitCheck) and by `make bench-core'.
+ */
+
+#ifndef TEXT_FIT_SAMPLES_HPP
+#define TEXT_FIT_SAMPLES_HPP
+
+static const char * const textFitSamples[] = {
+	/* ÀàÁáÂâÄäÈèÉéÊêÌìÍíÎîÒòÓóÔôÖöÙùÚúÛûÜü */
+	"\xC3\x80\xC3\xA0\xC3\x81\xC3\xA1\xC3\x82\xC3\xA2\xC3\x84\xC3\xA4\xC3\x88"
+	"\xC3\xA8\xC3\x89\xC3\xA9\xC3\x8A\xC3\xAA\xC3\x8C\xC3\xAC\xC3\x8D\xC3\xAD"
+	"\xC3\x8E\xC3\xAE\xC3\x92\xC3\xB2\xC3\x93\xC3\xB3\xC3\x94\xC3\xB4\xC3\x96"
+	"\xC3\xB6\xC3\x99\xC3\xB9\xC3\x9A\xC3\xBA\xC3\x9B\xC3\xBB\xC3\x9C\xC3\xBC",
+
+	/* 今日はこんにちは今日はこんにちは */
+	"\xE4\xBB\x8A\xE6\x97\xA5\xE3\x81\xAF\xE3\x81\x93\xE3\x82\x93\xE3\x81\xAB"
+	"\xE3\x81\xA1\xE3\x81\xAF\xE4\xBB\x8A\xE6\x97\xA5\xE3\x81\xAF\xE3\x81\x93"
+	"\xE3\x82\x93\xE3\x81\xAB\xE3\x81\xA1\xE3\x81\xAF",
+
+	"Right Shift",
+
+	/* invalid UTF-8 is taken as Windows-1252 */
+	"Stra\xDF" "e \x80\x93 Ende"
+};
+
+/* a key button, a narrow box */
+static const int textFitLimits[] = { 87, 40 };
+
+#endif  /* TEXT_FIT_SAMPLES_HPP */
@@ -0,0 +1,166 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+
+#include "trace.hpp"
+
+#define TRACE_MAX_EVENTS  4096
+
+
+typedef struct {
+	const char *name;
+	char ph;
+	long tid;
+	long long ts;  /* trace_clock() */
+	long long value;
+} trace_event_t;
+
+/* zero-initialized, so this can be used during static initialization */
+static trace_event_t events[TRACE_MAX_EVENTS];
+static volatile long eventCount = 0;
+static long eventsWritten = 0;
+
+
+static void trace_add(const char *name, char ph, long long value)
+{
+	long long now = trace_clock();
+	long n = trace_fetch_add(&eventCount, 1);
+
+	if (n >= TRACE_MAX_EVENTS) {
+		trace_fetch_add(&eventCount, -1);
+		return;
+	}
+
+	events[n].name = name;
+	events[n].ph = ph;
+	events[n].tid = trace_tid();
+	events[n].ts = now;
+	events[n].value = value;
+}
+
+bool trace_begin(const char *name)
+{
+	trace_add(name, 'B', 0);
+	return true;
+}
+
+bool trace_end(const char *name)
+{
+	trace_add(name, 'E', 0);
+	return true;
+}
+
+void trace_instant(const char *name)
+{
+	trace_add(name, 'i', 0);
+}
+
+void trace_counter(const char *name, long long value)
+{
+	trace_add(name, 'C', value);
+}
+
+void trace_memory(void)
+{
+	long long faults = -1, kib = -1;
+
+	trace_memory_info(&faults, &kib);
+
+	if (faults >= 0) {
+		trace_counter("page faults", faults);
+	}
+	if (kib >= 0) {
+		trace_counter("working set KiB", kib);
+	}
+}
+
+/* microseconds between process creation and the given timestamp */
+static double trace_ts(long long ts, long long tsNow, long long freq, double sinceCreation)
+{
+	return sinceCreation - static_cast<double>(tsNow - ts) * 1000000.0 / static_cast<double>(freq);
+}
+
+bool trace_write(void)
+{
+	long pid = trace_pid();
+	long count = eventCount;
+
+	if (count > TRACE_MAX_EVENTS) {
+		count = TRACE_MAX_EVENTS;
+	}
+
+	if (eventsWritten >= count) {
+		return false;
+	}
+
+	FILE *fp = trace_open();
+
+	if (!fp) {
+		return false;
+	}
+
+	/* map the timestamps onto the process lifetime, so the time the
+	 * loader spent before the first event is visible as well */
+	long long freq = trace_clock_freq();
+	long long now = trace_clock();
+	double since = trace_uptime_ms() * 1000.0;
+
+	fseek(fp, 0, SEEK_END);
+
+	if (ftell(fp) == 0) {
+		fputs("[\n", fp);
+	}
+
+	if (eventsWritten == 0) {
+		fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":0,"
+			"\"args\":{\"name\":\"SonicLauncher %ld\"}},\n", pid, pid);
+
+		/* time spent before the first recorded event (loader, static constructors) */
+		double first = trace_ts(events[0].ts, now, freq, since);
+		fprintf(fp, "{\"name\":\"process start\",\"ph\":\"X\",\"pid\":%ld,\"tid\":%ld,"
+			"\"ts\":0,\"dur\":%.3f},\n", pid, events[0].tid, first > 0 ? first : 0);
+	}
+
+	for (long i = eventsWritten; i < count; ++i) {
+		const trace_event_t *e = &events[i];
+		double ts = trace_ts(e->ts, now, freq, since);
+
+		if (e->ph == 'C') {
+			fprintf(fp, "{\"name\":\"%s\",\"ph\":\"C\",\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f,"
+				"\"args\":{\"value\":%lld}},\n", e->name, pid, e->tid, ts, e->value);
+		} else if (e->ph == 'i') {
+			fprintf(fp, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"p\",\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f},\n",
+				e->name, pid, e->tid, ts);
+		} else {
+			fprintf(fp, "{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f},\n",
+				e->name, e->ph, pid, e->tid, ts);
+		}
+	}
+
+	eventsWritten = count;
+	fclose(fp);
+
+	return true;
+}
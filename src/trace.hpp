@@ -0,0 +1,101 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Lightweight startup tracer.
+ *
+ * Events are always recorded into a fixed-size buffer (this is cheap and works
+ * during static initialization, before main() is entered).  They are only
+ * written out if the environment variable SONIC_LAUNCHER_TRACE points to a
+ * file.  The output uses the Chrome trace event format and can be opened with
+ * chrome://tracing or https://ui.perfetto.dev
+ *
+ * The file is opened in append mode and the closing bracket is omitted (which
+ * the format explicitly allows), so repeated runs accumulate in the same file
+ * and can be told apart by their process id.
+ *
+ * Event names must be string literals or otherwise outlive the process.
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <stdio.h>
+
+bool trace_begin(const char *name);
+bool trace_end(const char *name);
+void trace_instant(const char *name);
+void trace_counter(const char *name, long long value);
+
+/* record the page fault count and working set size as counters */
+void trace_memory(void);
+
+/* milliseconds since the process was created; uses the system clock,
+ * so the resolution is only about 1ms on older systems */
+double trace_uptime_ms(void);
+
+/* true if SONIC_LAUNCHER_TRACE is set */
+bool trace_enabled(void);
+
+/* append all events recorded since the last call to the trace file */
+bool trace_write(void);
+
+
+/* platform parts (trace_win32.cpp, trace_posix.cpp) */
+
+/* timestamps of the events and their ticks per second */
+long long trace_clock(void);
+long long trace_clock_freq(void);
+
+/* atomically add `n' to `*p' and return the old value */
+long trace_fetch_add(volatile long *p, long n);
+
+long trace_tid(void);
+long trace_pid(void);
+
+/* page faults and working set size; left alone if they can't be read */
+void trace_memory_info(long long *faults, long long *kib);
+
+/* the file named by SONIC_LAUNCHER_TRACE opened for appending, or NULL */
+FILE *trace_open(void);
+
+
+class TraceScope
+{
+private:
+	const char *_name;
+
+public:
+	TraceScope(const char *name)
+		: _name(name)
+	{
+		trace_begin(_name);
+	}
+
+	~TraceScope() {
+		trace_end(_name);
+	}
+};
+
+#endif  /* TRACE_HPP */
@@ -0,0 +1,143 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "trace.hpp"
+
+#define TRACE_ENV  "SONIC_LAUNCHER_TRACE"
+
+
+static long long now_ns(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+	return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+long long trace_clock(void)
+{
+	return now_ns(CLOCK_MONOTONIC);
+}
+
+long long trace_clock_freq(void)
+{
+	return 1000000000LL;
+}
+
+long trace_fetch_add(volatile long *p, long n)
+{
+	return __sync_fetch_and_add(p, n);
+}
+
+long trace_tid(void)
+{
+	return syscall(SYS_gettid);
+}
+
+long trace_pid(void)
+{
+	return static_cast<long>(getpid());
+}
+
+/* the resident set size is the closest thing to the working set */
+static long resident_kib(void)
+{
+	long pages = 0, resident = 0;
+	FILE *fp = fopen("/proc/self/statm", "r");
+
+	if (!fp) {
+		return -1;
+	}
+
+	if (fscanf(fp, "%ld %ld", &pages, &resident) != 2) {
+		resident = -1;
+	}
+	fclose(fp);
+
+	return (resident < 0) ? -1 : resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void trace_memory_info(long long *faults, long long *kib)
+{
+	struct rusage ru;
+
+	if (getrusage(RUSAGE_SELF, &ru) == 0) {
+		*faults = ru.ru_minflt + ru.ru_majflt;
+	}
+	*kib = resident_kib();
+}
+
+static const char *trace_file(void)
+{
+	const char *path = getenv(TRACE_ENV);
+	return (path && *path) ? path : NULL;
+}
+
+bool trace_enabled(void)
+{
+	return trace_file() != NULL;
+}
+
+FILE *trace_open(void)
+{
+	const char *path = trace_file();
+	return path ? fopen(path, "ab") : NULL;
+}
+
+/* the start time in /proc/self/stat is in clock ticks since boot,
+ * which is CLOCK_BOOTTIME */
+double trace_uptime_ms(void)
+{
+	char buf[1024];
+	unsigned long long start = 0;
+	FILE *fp = fopen("/proc/self/stat", "r");
+
+	if (!fp) {
+		return 0;
+	}
+
+	size_t n = fread(buf, 1, sizeof(buf) - 1, fp);
+	fclose(fp);
+	buf[n] = 0;
+
+	/* the command name can contain spaces, the fields after it can't */
+	const char *p = strrchr(buf, ')');
+
+	if (!p || sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu", &start) != 1) {
+		return 0;
+	}
+
+	long long created = static_cast<long long>(start) * (1000000000LL / sysconf(_SC_CLK_TCK));
+	long long now = now_ns(CLOCK_BOOTTIME);
+
+	return (now > created) ? static_cast<double>(now - created) / 1000000.0 : 0;
+}
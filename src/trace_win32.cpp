@@ -0,0 +1,116 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <windows.h>
+#include <psapi.h>
+
+#include <stdio.h>
+#include <wchar.h>
+
+#include "trace.hpp"
+
+#define TRACE_ENV  L"SONIC_LAUNCHER_TRACE"
+
+
+long long trace_clock(void)
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return now.QuadPart;
+}
+
+long long trace_clock_freq(void)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return freq.QuadPart;
+}
+
+long trace_fetch_add(volatile long *p, long n)
+{
+	return InterlockedExchangeAdd(p, n);
+}
+
+long trace_tid(void)
+{
+	return static_cast<long>(GetCurrentThreadId());
+}
+
+long trace_pid(void)
+{
+	return static_cast<long>(GetCurrentProcessId());
+}
+
+void trace_memory_info(long long *faults, long long *kib)
+{
+	PROCESS_MEMORY_COUNTERS pmc;
+
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+		*faults = pmc.PageFaultCount;
+		*kib = pmc.WorkingSetSize / 1024;
+	}
+}
+
+static bool trace_file(wchar_t *buf, DWORD len)
+{
+	DWORD rv = GetEnvironmentVariableW(TRACE_ENV, buf, len);
+	return (rv > 0 && rv < len);
+}
+
+bool trace_enabled(void)
+{
+	wchar_t buf[MAX_PATH];
+	return trace_file(buf, MAX_PATH);
+}
+
+FILE *trace_open(void)
+{
+	wchar_t path[MAX_PATH];
+	FILE *fp = NULL;
+
+	if (!trace_file(path, MAX_PATH) || _wfopen_s(&fp, path, L"ab") != 0) {
+		return NULL;
+	}
+	return fp;
+}
+
+double trace_uptime_ms(void)
+{
+	FILETIME ftCreation, ftExit, ftKernel, ftUser, ftNow;
+	ULARGE_INTEGER creation, current;
+
+	GetSystemTimeAsFileTime(&ftNow);
+	GetProcessTimes(GetCurrentProcess(), &ftCreation, &ftExit, &ftKernel, &ftUser);
+
+	creation.LowPart = ftCreation.dwLowDateTime;
+	creation.HighPart = ftCreation.dwHighDateTime;
+	current.LowPart = ftNow.dwLowDateTime;
+	current.HighPart = ftNow.dwHighDateTime;
+
+	/* FILETIME is in 100ns units */
+	if (current.QuadPart <= creation.QuadPart) {
+		return 0;
+	}
+	return static_cast<double>(current.QuadPart - creation.QuadPart) / 10000.0;
+}
@@ -0,0 +1,284 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "lang_pack.hpp"
+
+#define UI_STRINGS_DATA
+#include "ui_strings.hpp"
+
+/* the configuration stores the language in a byte */
+#define MAX_LANGUAGES  255
+
+
+static std::vector<langPack> packs;  /* mapped files */
+
+static unsigned int current = 0;
+static const uint32_t *offsets = ui_offsets[0];
+static const langPack *pack = NULL;  /* the current language is a pack */
+
+
+const char *ui_str(ui_id id)
+{
+	const char *str;
+
+	if (!pack) {
+		return ui_blob + offsets[id];
+	}
+	if ((str = lang_pack_str(*pack, id)) != NULL) {
+		return str;
+	}
+	return ui_blob + ui_offsets[0][id];  /* English */
+}
+
+unsigned int ui_lang_count(void)
+{
+	return UI_LANGUAGES + static_cast<unsigned int>(packs.size());
+}
+
+const char *ui_lang_name(unsigned int lang)
+{
+	if (lang < UI_LANGUAGES) {
+		return ui_blob + ui_offsets[lang][UI_LANGUAGE_NAME];
+	}
+
+	lang -= UI_LANGUAGES;
+
+	if (lang >= packs.size()) {
+		return NULL;
+	}
+
+	return lang_pack_str(packs.at(lang), UI_LANGUAGE_NAME);
+}
+
+bool ui_lang_set(unsigned int lang)
+{
+	if (lang < UI_LANGUAGES) {
+		offsets = ui_offsets[lang];
+		pack = NULL;
+		current = lang;
+		return true;
+	}
+
+	if (lang - UI_LANGUAGES >= packs.size()) {
+		return false;
+	}
+
+	langPack &p = packs.at(lang - UI_LANGUAGES);
+
+	if (!lang_pack_check(p)) {
+		return false;
+	}
+
+	pack = &p;
+	current = lang;
+
+	return true;
+}
+
+unsigned int ui_lang(void)
+{
+	return current;
+}
+
+#ifdef _WIN32
+
+static bool map_pack(const wchar_t *path, langPack &p)
+{
+	HANDLE file, mapping;
+	LARGE_INTEGER size;
+
+	file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < LANG_PACK_HEADER || size.QuadPart > LANG_PACK_MAX_SIZE) {
+		CloseHandle(file);
+		return false;
+	}
+
+	/* the view stays valid after the handles are closed */
+	mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+
+	if (!mapping) {
+		return false;
+	}
+
+	const uint8_t *data = reinterpret_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	CloseHandle(mapping);
+
+	if (!data) {
+		return false;
+	}
+
+	if (!lang_pack_open(data, static_cast<size_t>(size.QuadPart), UI_LANGUAGE_NAME, p)) {
+		UnmapViewOfFile(data);
+		return false;
+	}
+
+	return true;
+}
+
+static void unmap_pack(const langPack &p)
+{
+	UnmapViewOfFile(p.data);
+}
+
+void ui_lang_packs(const wchar_t *dir)
+{
+	std::wstring pattern = std::wstring(dir) + L"\\*.lang";
+	std::vector<std::wstring> files;
+	WIN32_FIND_DATAW fd;
+	HANDLE h;
+
+	if (!packs.empty() || (h = FindFirstFileW(pattern.c_str(), &fd)) == INVALID_HANDLE_VALUE) {
+		return;
+	}
+
+	do {
+		if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+			files.push_back(fd.cFileName);
+		}
+	} while (FindNextFileW(h, &fd));
+
+	FindClose(h);
+
+	/* the configuration refers to a language by its position */
+	std::sort(files.begin(), files.end());
+
+	for (size_t i = 0; i < files.size() && ui_lang_count() < MAX_LANGUAGES; ++i) {
+		std::wstring path = std::wstring(dir) + L"\\" + files.at(i);
+		langPack p;
+
+		if (map_pack(path.c_str(), p)) {
+			packs.push_back(p);
+		}
+	}
+}
+
+#else
+
+static bool map_pack(const char *path, langPack &p)
+{
+	struct stat st;
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+	if (fd == -1) {
+		return false;
+	}
+
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < LANG_PACK_HEADER || st.st_size > LANG_PACK_MAX_SIZE) {
+		close(fd);
+		return false;
+	}
+
+	/* the mapping stays valid after the file is closed */
+	void *data = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		return false;
+	}
+
+	if (!lang_pack_open(reinterpret_cast<const uint8_t *>(data), static_cast<size_t>(st.st_size), UI_LANGUAGE_NAME, p)) {
+		munmap(data, static_cast<size_t>(st.st_size));
+		return false;
+	}
+
+	return true;
+}
+
+static void unmap_pack(const langPack &p)
+{
+	/* lang_pack_open() checked that this is the size of the file */
+	size_t size = LANG_PACK_HEADER + static_cast<size_t>(p.count) * 4 + p.size;
+	munmap(const_cast<uint8_t *>(p.data), size);
+}
+
+void ui_lang_packs(const char *dir)
+{
+	std::vector<std::string> files;
+	struct dirent *e;
+	DIR *d;
+
+	if (!packs.empty() || (d = opendir(dir)) == NULL) {
+		return;
+	}
+
+	while ((e = readdir(d)) != NULL) {
+		size_t len = strlen(e->d_name);
+
+		if (len > 5 && strcmp(e->d_name + len - 5, ".lang") == 0) {
+			files.push_back(e->d_name);
+		}
+	}
+
+	closedir(d);
+
+	/* the configuration refers to a language by its position */
+	std::sort(files.begin(), files.end());
+
+	for (size_t i = 0; i < files.size() && ui_lang_count() < MAX_LANGUAGES; ++i) {
+		std::string path = std::string(dir) + "/" + files.at(i);
+		langPack p;
+
+		if (map_pack(path.c_str(), p)) {
+			packs.push_back(p);
+		}
+	}
+}
+
+#endif  /* _WIN32 */
+
+void ui_lang_packs_free(void)
+{
+	if (pack) {
+		offsets = ui_offsets[0];
+		pack = NULL;
+		current = 0;
+	}
+
+	for (size_t i = 0; i < packs.size(); ++i) {
+		unmap_pack(packs.at(i));
+	}
+	packs.clear();
+}
@@ -0,0 +1,84 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Translated strings.
+ *
+ * The built-in languages are compiled in by assetc from lang.txt: every
+ * string is stored once in a single blob and each language has a table of
+ * offsets into it, indexed by the string IDs in lang.h.
+ *
+ * More languages can be shipped as packs in the "lang" directory next to the
+ * executable, without rebuilding the launcher:
+ *
+ *   assetc langpack table.txt column name.lang
+ *
+ * Packs are memory-mapped.  When they are found only the header and the name
+ * of the language are read; the offsets are checked when the language is
+ * selected, so only the pages of the current language are ever touched.
+ * Strings that a pack doesn't have (packs made for an older lang.txt) are
+ * shown in English.
+ *
+ * Pack format, little endian:
+ *   "SLL" 0x01
+ *   uint32    number of strings, in the order of the string IDs
+ *   uint32    size of the string data
+ *   uint32[]  offset of every string in the string data
+ *   char[]    NUL-terminated UTF-8 strings
+ */
+
+#ifndef UI_STRINGS_HPP
+#define UI_STRINGS_HPP
+
+#ifdef __GNUC__
+#include "lang.h"
+#else
+#include "../Obj/lang.h"
+#endif
+
+/* a string in the current language */
+const char *ui_str(ui_id id);
+
+/* the built-in languages come first, then the packs */
+unsigned int ui_lang_count(void);
+
+/* name of a language in that language */
+const char *ui_lang_name(unsigned int lang);
+
+/* select a language; returns false and keeps the current one if it doesn't
+ * exist or if the pack is broken */
+bool ui_lang_set(unsigned int lang);
+unsigned int ui_lang(void);
+
+/* map the language packs (*.lang) in a directory, sorted by file name */
+#ifdef _WIN32
+void ui_lang_packs(const wchar_t *dir);
+#else
+void ui_lang_packs(const char *dir);
+#endif
+
+/* unmap the language packs; if one of them was selected, it's English again */
+void ui_lang_packs_free(void);
+
+#endif  /* UI_STRINGS_HPP */
@@ -0,0 +1,68 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <windows.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "window_hooks.hpp"
+
+
+static std::vector<window_hook_t> hooks;
+static WNDPROC prevWndProc = NULL;
+
+
+static LRESULT CALLBACK hooks_wndproc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	for (size_t i = 0; i < hooks.size(); ++i) {
+		hooks.at(i)(msg, wParam, lParam);
+	}
+
+	return CallWindowProcW(prevWndProc, hwnd, msg, wParam, lParam);
+}
+
+void window_hook_add(window_hook_t hook)
+{
+	if (std::find(hooks.begin(), hooks.end(), hook) == hooks.end()) {
+		hooks.push_back(hook);
+	}
+}
+
+void window_hooks_attach(HWND hwnd)
+{
+	if (!hwnd) {
+		return;
+	}
+
+	WNDPROC proc = reinterpret_cast<WNDPROC>(GetWindowLongPtrW(hwnd, GWLP_WNDPROC));
+
+	if (proc == hooks_wndproc) {
+		return;
+	}
+
+	/* all launcher windows share FLTK's window procedure */
+	prevWndProc = proc;
+	SetWindowLongPtrW(hwnd, GWLP_WNDPROC, reinterpret_cast<LONG_PTR>(hooks_wndproc));
+}
@@ -0,0 +1,48 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2020, djcj <djcj@gmx.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Window message hooks.
+ *
+ * FLTK 1.3 doesn't pass on messages it doesn't handle itself, so the window
+ * procedure of the launcher window is subclassed and every message is shown
+ * to the registered hooks before FLTK gets it.
+ *
+ * Hooks are called on the main thread and can't consume a message.
+ */
+
+#ifndef WINDOW_HOOKS_HPP
+#define WINDOW_HOOKS_HPP
+
+#include <windows.h>
+
+typedef void (*window_hook_t)(UINT msg, WPARAM wParam, LPARAM lParam);
+
+/* register a hook; adding the same one twice has no effect */
+void window_hook_add(window_hook_t hook);
+
+/* subclass a window; call again if the window was recreated */
+void window_hooks_attach(HWND hwnd);
+
+#endif  /* WINDOW_HOOKS_HPP */